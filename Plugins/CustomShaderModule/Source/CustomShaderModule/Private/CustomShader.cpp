@@ -19,6 +19,10 @@
 #include "RHIResources.h"
 #include "ShaderParameters.h"
 
+#include "DeformMeshStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Draw Test Shader RT"), STAT_DeformMeshDrawTestShader, STATGROUP_DeformMesh);
+
 BEGIN_GLOBAL_SHADER_PARAMETER_STRUCT(FMyUniformStruct, )
 SHADER_PARAMETER(FVector4, ColorOne)
 SHADER_PARAMETER(FVector4, ColorTwo)
@@ -384,6 +388,7 @@ void DrawTestShaderRenderTarget_RenderThread(
 )
 {
 	check(IsInRenderingThread());
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshDrawTestShader);
 
 	if (false)
 	{
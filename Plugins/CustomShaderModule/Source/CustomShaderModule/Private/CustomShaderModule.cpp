@@ -2,21 +2,30 @@
 
 #include "CustomShaderModule.h"
 #include "Interfaces/IPluginManager.h"
+#include "Misc/CoreDelegates.h"
+#include "DeformMeshStats.h"
+#include "DeformMeshTransformPool.h"
 
 #define LOCTEXT_NAMESPACE "FCustomShaderModuleModule"
 
+UE_TRACE_CHANNEL_DEFINE(DeformMeshChannel);
+
 void FCustomShaderModuleModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	FString PluginShaderDir = FPaths::Combine(IPluginManager::Get().FindPlugin(TEXT("CustomShaderModule"))->GetBaseDir(), TEXT("Shaders"));
 	AddShaderSourceDirectoryMapping(TEXT("/Plugin/CustomShaderModule"), PluginShaderDir);
+
+	// scene view extension ҪGEngine
+	FCoreDelegates::OnPostEngineInit.AddStatic(&RegisterDeformMeshTransformPoolExtension);
 }
 
 void FCustomShaderModuleModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	UnregisterDeformMeshTransformPoolExtension();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -3,17 +3,26 @@
 
 #include "DeformMeshActor.h"
 #include "DeformMeshComponent.h"
+#include "DeformMeshActorSubsystem.h"
+#include "Engine/World.h"
 
 // Sets default values
 ADeformMeshActor::ADeformMeshActor()
 {
 	DeformMeshComp =  CreateDefaultSubobject< UDeformMeshComponent>(TEXT("DeformComponnet"));
-	DeformController = CreateDefaultSubobject<AActor>(TEXT("DeformController"));
 
 	DeformMeshComp->SetupAttachment(GetRootComponent());
 
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// ԭĬcontroller ûroot component actor, ֻÿ֡ѯ
+	// scene component, ƶʱTransformUpdated ֪ͨ
+	DeformControllerComponent = CreateDefaultSubobject<USceneComponent>(TEXT("DeformController"));
+	DeformControllerComponent->SetupAttachment(DeformMeshComp);
+	DeformControllerComponent->SetUsingAbsoluteLocation(true);
+	DeformControllerComponent->SetUsingAbsoluteRotation(true);
+	DeformControllerComponent->SetUsingAbsoluteScale(true);
+
+	// section transform UDeformMeshActorSubsystem 
+	PrimaryActorTick.bCanEverTick = false;
 
 }
 
@@ -22,15 +31,54 @@ void ADeformMeshActor::BeginPlay()
 {
 	Super::BeginPlay();
 	
-	DeformMeshComp->CreateSection(0, SourceMesh, DeformController->GetTransform());
+	// ֻcontroller ƶ֮
+	ControllerRoot = DeformController ? DeformController->GetRootComponent() : DeformControllerComponent;
+
+	DeformMeshComp->CreateSection(0, SourceMesh, GetControllerTransform());
+
+	if (ControllerRoot.IsValid())
+	{
+		ControllerTransformUpdatedHandle = ControllerRoot->TransformUpdated.AddUObject(this, &ADeformMeshActor::OnControllerTransformUpdated);
+	}
+
+	if (UDeformMeshActorSubsystem* subsystem = GetWorld()->GetSubsystem<UDeformMeshActorSubsystem>())
+	{
+		subsystem->RegisterActor(this, !ControllerRoot.IsValid());
+	}
 }
 
-// Called every frame
-void ADeformMeshActor::Tick(float DeltaTime)
+void ADeformMeshActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	if (ControllerRoot.IsValid())
+	{
+		ControllerRoot->TransformUpdated.Remove(ControllerTransformUpdatedHandle);
+	}
+	ControllerRoot = nullptr;
+
+	if (UDeformMeshActorSubsystem* subsystem = GetWorld()->GetSubsystem<UDeformMeshActorSubsystem>())
+	{
+		subsystem->UnregisterActor(this);
+	}
 
-	DeformMeshComp->UpdateSectionTransform(0, DeformController->GetTransform());
-	DeformMeshComp->FinishDeformUpdate();
+	Super::EndPlay(EndPlayReason);
+}
+
+FTransform ADeformMeshActor::GetControllerTransform() const
+{
+	if (DeformController)
+	{
+		return DeformController->GetTransform();
+	}
+	return DeformControllerComponent->GetComponentTransform();
+}
+
+void ADeformMeshActor::OnControllerTransformUpdated(USceneComponent* UpdatedComponent,
+	EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	// ͬһ֡ƶҲֻsubsystem Tick иһ
+	if (UDeformMeshActorSubsystem* subsystem = GetWorld()->GetSubsystem<UDeformMeshActorSubsystem>())
+	{
+		subsystem->MarkActorDirty(this);
+	}
 }
 
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DeformMeshActorSubsystem.h"
+#include "DeformMeshActor.h"
+#include "DeformMeshComponent.h"
+#include "Async/ParallelFor.h"
+#include "DeformMeshStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Actor Batch Tick"), STAT_DeformMeshActorBatchTick, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actors Checked"), STAT_DeformMeshActorsChecked, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Actors Updated"), STAT_DeformMeshActorsUpdated, STATGROUP_DeformMesh);
+
+// ParallelFor ÿtask Ƚϵactor 
+static constexpr int32 DeformMeshActorChunkSize = 256;
+
+void UDeformMeshActorSubsystem::RegisterActor(ADeformMeshActor* Actor, bool bPollEveryFrame)
+{
+	check(Actor->BatchTickIndex == INDEX_NONE);
+
+	Actor->BatchTickIndex = Actors.Add(Actor);
+	LastTransforms.Add(Actor->GetControllerTransform());
+	PollEveryFrame.Add(bPollEveryFrame);
+	DirtyActors.Add(false);
+	if (bPollEveryFrame)
+	{
+		PolledActors.Add(Actor);
+	}
+}
+
+void UDeformMeshActorSubsystem::UnregisterActor(ADeformMeshActor* Actor)
+{
+	const int32 index = Actor->BatchTickIndex;
+	if (index == INDEX_NONE)
+	{
+		return;
+	}
+	check(Actors[index] == Actor);
+
+	if (PollEveryFrame[index])
+	{
+		PolledActors.RemoveSingleSwap(Actor, false);
+	}
+	if (DirtyActors[index])
+	{
+		DirtyList.RemoveSingleSwap(Actor, false);
+	}
+
+	// һactor Ƶindex
+	const int32 last = Actors.Num() - 1;
+	if (index != last)
+	{
+		Actors[index] = Actors[last];
+		Actors[index]->BatchTickIndex = index;
+		LastTransforms[index] = LastTransforms[last];
+		PollEveryFrame[index] = PollEveryFrame[last];
+		DirtyActors[index] = DirtyActors[last];
+	}
+	Actors.RemoveAt(last, 1, false);
+	LastTransforms.RemoveAt(last, 1, false);
+	PollEveryFrame.RemoveAt(last);
+	DirtyActors.RemoveAt(last);
+
+	Actor->BatchTickIndex = INDEX_NONE;
+}
+
+void UDeformMeshActorSubsystem::MarkActorDirty(ADeformMeshActor* Actor)
+{
+	const int32 index = Actor->BatchTickIndex;
+	if (index != INDEX_NONE && !PollEveryFrame[index] && !DirtyActors[index])
+	{
+		DirtyActors[index] = true;
+		DirtyList.Add(Actor);
+	}
+}
+
+void UDeformMeshActorSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshActorBatchTick);
+
+#pragma region GatherControllerTransforms
+	// actor ֻgame thread
+	// ֻѯյ֪ͨactor, ɨȫactor
+	CandidateActors.Reset();
+	CandidateTransforms.Reset();
+	for (ADeformMeshActor* actor : PolledActors)
+	{
+		CandidateActors.Add(actor->BatchTickIndex);
+		CandidateTransforms.Add(actor->GetControllerTransform());
+	}
+	for (ADeformMeshActor* actor : DirtyList)
+	{
+		DirtyActors[actor->BatchTickIndex] = false;
+		CandidateActors.Add(actor->BatchTickIndex);
+		CandidateTransforms.Add(actor->GetControllerTransform());
+	}
+	DirtyList.Reset();
+
+	const int32 numCandidates = CandidateActors.Num();
+	if (numCandidates == 0)
+	{
+		return;
+	}
+	INC_DWORD_STAT_BY(STAT_DeformMeshActorsChecked, numCandidates);
+#pragma endregion
+
+#pragma region CompareTransforms
+	// ֻд, ÿchunk дͬԪ
+	CandidateChanged.SetNumUninitialized(numCandidates);
+	const int32 numChunks = FMath::DivideAndRoundUp(numCandidates, DeformMeshActorChunkSize);
+	ParallelFor(numChunks, [this, numCandidates](int32 ChunkIndex)
+		{
+			const int32 chunkEnd = FMath::Min((ChunkIndex + 1) * DeformMeshActorChunkSize, numCandidates);
+			for (int32 i = ChunkIndex * DeformMeshActorChunkSize; i < chunkEnd; i++)
+			{
+				const int32 index = CandidateActors[i];
+				const bool bChanged = !CandidateTransforms[i].Equals(LastTransforms[index], Actors[index]->TransformTolerance);
+				CandidateChanged[i] = bChanged;
+				if (bChanged)
+				{
+					LastTransforms[index] = CandidateTransforms[i];
+				}
+			}
+		}, numChunks == 1);
+#pragma endregion
+
+#pragma region UpdateComponents
+	TArray<UDeformMeshComponent*> components;
+	TArray<int32> sectionIndices;
+	TArray<FTransform> transforms;
+	for (int32 i = 0; i < numCandidates; i++)
+	{
+		if (CandidateChanged[i])
+		{
+			components.Add(Actors[CandidateActors[i]]->DeformMeshComp);
+			sectionIndices.Add(0);
+			transforms.Add(CandidateTransforms[i]);
+		}
+	}
+
+	if (components.Num() > 0)
+	{
+		UDeformMeshComponent::UpdateSectionTransformsBatched(components, sectionIndices, transforms);
+		INC_DWORD_STAT_BY(STAT_DeformMeshActorsUpdated, components.Num());
+	}
+#pragma endregion
+}
+
+bool UDeformMeshActorSubsystem::IsTickable() const
+{
+	return PolledActors.Num() > 0 || DirtyList.Num() > 0;
+}
+
+ETickableTickType UDeformMeshActorSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+UWorld* UDeformMeshActorSubsystem::GetTickableGameObjectWorld() const
+{
+	return GetWorld();
+}
+
+TStatId UDeformMeshActorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDeformMeshActorSubsystem, STATGROUP_Tickables);
+}
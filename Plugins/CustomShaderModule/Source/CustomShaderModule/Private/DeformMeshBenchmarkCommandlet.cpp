@@ -0,0 +1,552 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DeformMeshBenchmarkCommandlet.h"
+#include "DeformMeshActor.h"
+#include "DeformMeshActorSubsystem.h"
+#include "DeformMeshComponent.h"
+#include "DeformMeshTransformPool.h"
+#include "DeformMeshRendering.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "SceneInterface.h"
+#include "SceneView.h"
+#include "RenderingThread.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDeformMeshBenchmark, Log, All);
+
+/** в */
+struct FDeformMeshBenchmarkOptions
+{
+	TArray<int32> ActorCounts = { 1, 16, 64 };
+	TArray<int32> SectionCounts = { 16, 256, 4096 };
+	TArray<float> UpdateFractions = { 0.f, 0.1f, 1.f };
+	int32 Frames = 120;
+	int32 WarmupFrames = 10;
+	int32 Seed = 1;
+	FString MeshPath = TEXT("/Engine/BasicShapes/Cube.Cube");
+	FString OutputPath;
+	bool bPerFrame = false;
+	// ûrender scene ʱʧ, ֻgame thread Ľ
+	bool bRequireRenderScene = false;
+	// 0 ʱһ֮֡ÿproxy ôsection 
+	int32 ProxyIterations = 0;
+	// ÿr.DeformMesh.AsyncProxyBuild=0 õǰֵһ
+	bool bCompareAsyncProxyBuild = false;
+};
+
+/** sweep еһ */
+struct FDeformMeshBenchmarkConfig
+{
+	int32 NumActors;
+	int32 NumSections;
+	float UpdateFraction;
+};
+
+struct FDeformMeshBenchmarkResult
+{
+	FDeformMeshBenchmarkConfig Config;
+
+	// ÿ֡UpdateSectionTransform Ĵ (ÿactor)
+	int32 SectionsUpdatedPerFrame = 0;
+
+	// spawn actor section
+	double SpawnMs = 0.0;
+
+	// һ֡game thread ʱ, proxy
+	double FirstFrameMs = 0.0;
+
+	// component proxy ĵһ֡, 첽build proxy ʱ֡, ûrender scene ʱINDEX_NONE
+	int32 ProxyReadyFrame = INDEX_NONE;
+
+	// õworld render scene, ûʱᴴproxy, render thread ʱû
+	bool bHasRenderScene = false;
+
+	// -ProxyIterations: proxy һGetDynamicMeshElements section ʱ֮, ûвʱǸ
+	double ProxyIterationMs = -1.0;
+	// һαɵbatch element , ȷϲͬbuild ޳Ľһ
+	int32 ProxyBatchElements = 0;
+
+	// ʱr.DeformMesh.AsyncProxyBuild ֵ, 0 game thread build
+	int32 AsyncProxyBuild = 0;
+
+	// warmup ֮ÿ֡ʱ
+	// GameThread: transform, tick world, end of frame update
+	// RenderThread: render thread ִһ֡һһrender command ʱ
+	// Flush: game thread ֮ȴrender thread ʱ, Ҳûбgame thread ڸǵrender thread ʱ
+	// ûrender scene ʱRenderThread Flush ֻǿ֡ʱ, ʱ
+	TArray<double> GameThreadMs;
+	TArray<double> RenderThreadMs;
+	TArray<double> FlushMs;
+};
+
+/** һʱͳ */
+struct FDeformMeshBenchmarkTimes
+{
+	double Avg = 0.0;
+	double P50 = 0.0;
+	double P95 = 0.0;
+	double Max = 0.0;
+};
+
+static FDeformMeshBenchmarkTimes SummarizeTimes(TArray<double> Times)
+{
+	FDeformMeshBenchmarkTimes summary;
+	if (Times.Num() == 0)
+	{
+		return summary;
+	}
+
+	Times.Sort();
+	for (double time : Times)
+	{
+		summary.Avg += time;
+	}
+	summary.Avg /= Times.Num();
+	summary.P50 = Times[Times.Num() / 2];
+	summary.P95 = Times[FMath::Min(FMath::FloorToInt(Times.Num() * 0.95f), Times.Num() - 1)];
+	summary.Max = Times.Last();
+	return summary;
+}
+
+/**  -Name=1,2,3 ʽб, ûʱĬֵ */
+template<typename T>
+static void ParseList(const FString& Params, const TCHAR* Name, TArray<T>& OutValues)
+{
+	FString value;
+	// ڶŴֹͣ
+	if (!FParse::Value(*Params, Name, value, false))
+	{
+		return;
+	}
+
+	TArray<FString> items;
+	value.ParseIntoArray(items, TEXT(","));
+	OutValues.Reset();
+	for (const FString& item : items)
+	{
+		T parsed;
+		LexFromString(parsed, *item.TrimStartAndEnd());
+		OutValues.Add(parsed);
+	}
+}
+
+static FTransform RandomDeformTransform(FRandomStream& Random)
+{
+	const FRotator rotation(Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f));
+	return FTransform(rotation, Random.GetUnitVector() * Random.FRandRange(0.f, 500.f), FVector(Random.FRandRange(0.5f, 2.f)));
+}
+
+/**
+ * һµgame world spawn Config.NumActors actor, ÿConfig.NumSections section,
+ * WarmupFrames + Frames ֡, ÿ֡UpdateFraction section
+ */
+static FDeformMeshBenchmarkResult RunBenchmarkConfig(const FDeformMeshBenchmarkConfig& Config,
+	const FDeformMeshBenchmarkOptions& Options, UStaticMesh* Mesh)
+{
+	FDeformMeshBenchmarkResult result;
+	result.Config = Config;
+	result.SectionsUpdatedPerFrame = FMath::RoundToInt(Config.UpdateFraction * Config.NumSections);
+	result.AsyncProxyBuild = IConsoleManager::Get().FindConsoleVariable(TEXT("r.DeformMesh.AsyncProxyBuild"))->GetInt();
+
+	// ÿͬ, ڲͬbuild ֮Ƚ
+	FRandomStream random(Options.Seed);
+
+#pragma region CreateWorld
+	UWorld* world = UWorld::CreateWorld(EWorldType::Game, false, TEXT("DeformMeshBenchmark"));
+	FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	worldContext.SetCurrentWorld(world);
+	world->InitializeActorsForPlay(FURL());
+	world->BeginPlay();
+
+	// -nullrhi ʱFNULLSceneInterface, ᴴproxy
+	const bool bHasRenderScene = world->Scene != nullptr && world->Scene->GetRenderScene() != nullptr;
+	result.bHasRenderScene = bHasRenderScene;
+#pragma endregion
+
+#pragma region SpawnActors
+	TArray<UDeformMeshComponent*> components;
+	const double spawnStart = FPlatformTime::Seconds();
+	for (int32 actorIndex = 0; actorIndex < Config.NumActors; actorIndex++)
+	{
+		const FTransform actorTransform(FVector(actorIndex * 1000.f, 0.f, 0.f));
+		ADeformMeshActor* actor = world->SpawnActorDeferred<ADeformMeshActor>(ADeformMeshActor::StaticClass(), actorTransform);
+		actor->SourceMesh = Mesh;
+		// BeginPlay дsection 0
+		actor->FinishSpawning(actorTransform);
+		// transform benchmark , subsystem 
+		world->GetSubsystem<UDeformMeshActorSubsystem>()->UnregisterActor(actor);
+
+		UDeformMeshComponent* deformCom = actor->DeformMeshComp;
+		for (int32 sectionIndex = 1; sectionIndex < Config.NumSections; sectionIndex++)
+		{
+			deformCom->CreateSection(sectionIndex, Mesh, RandomDeformTransform(random));
+		}
+		components.Add(deformCom);
+	}
+	result.SpawnMs = (FPlatformTime::Seconds() - spawnStart) * 1000.0;
+#pragma endregion
+
+#pragma region TickFrames
+	const float deltaSeconds = 1.f / 60.f;
+	for (int32 frame = 0; frame < Options.WarmupFrames + Options.Frames; frame++)
+	{
+		// render thread д, FlushRenderingCommands ֮game thread ȡ
+		uint64 renderBeginCycles = 0;
+		uint64 renderEndCycles = 0;
+		uint64* renderBeginPtr = &renderBeginCycles;
+		uint64* renderEndPtr = &renderEndCycles;
+
+		ENQUEUE_RENDER_COMMAND(FDeformMeshBenchmarkBegin)(
+			[renderBeginPtr](FRHICommandListImmediate& RHICmdList)
+			{
+				*renderBeginPtr = FPlatformTime::Cycles64();
+			});
+
+		const double frameStart = FPlatformTime::Seconds();
+		for (UDeformMeshComponent* deformCom : components)
+		{
+			for (int32 update = 0; update < result.SectionsUpdatedPerFrame; update++)
+			{
+				deformCom->UpdateSectionTransform(random.RandRange(0, Config.NumSections - 1), RandomDeformTransform(random));
+			}
+			deformCom->FinishDeformUpdate();
+		}
+
+		world->Tick(LEVELTICK_All, deltaSeconds);
+		// 첽proxy build ɻصgame thread ִ
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		world->SendAllEndOfFrameUpdates();
+		const double gameThreadMs = (FPlatformTime::Seconds() - frameStart) * 1000.0;
+
+		// ûview Ⱦ, scene view extension Flush, ﴦһ֡ĸ²ϴtransform
+		ENQUEUE_RENDER_COMMAND(FDeformMeshBenchmarkEnd)(
+			[renderEndPtr](FRHICommandListImmediate& RHICmdList)
+			{
+				DrainDeformMeshUpdateQueue_RenderThread();
+				GDeformMeshTransformPool.Flush(RHICmdList);
+				*renderEndPtr = FPlatformTime::Cycles64();
+			});
+
+		const double flushStart = FPlatformTime::Seconds();
+		FlushRenderingCommands();
+		const double flushMs = (FPlatformTime::Seconds() - flushStart) * 1000.0;
+
+		if (frame == 0)
+		{
+			result.FirstFrameMs = gameThreadMs;
+		}
+
+		if (bHasRenderScene && result.ProxyReadyFrame == INDEX_NONE &&
+			!components.ContainsByPredicate([](const UDeformMeshComponent* deformCom) { return deformCom->SceneProxy == nullptr; }))
+		{
+			result.ProxyReadyFrame = frame;
+		}
+
+		if (frame >= Options.WarmupFrames)
+		{
+			result.GameThreadMs.Add(gameThreadMs);
+			result.RenderThreadMs.Add(FPlatformTime::ToMilliseconds64(renderEndCycles - renderBeginCycles));
+			result.FlushMs.Add(flushMs);
+		}
+	}
+#pragma endregion
+
+#pragma region TimeProxyIteration
+	// FDeformMeshSceneProxy section , ǿݽṹ
+	if (bHasRenderScene && Options.ProxyIterations > 0 && result.ProxyReadyFrame != INDEX_NONE)
+	{
+		// ̶, actor еһ˿һ, һsection ᱻ޳
+		FSceneViewFamilyContext viewFamily(FSceneViewFamily::ConstructionValues(nullptr, world->Scene, FEngineShowFlags(ESFIM_Game))
+			.SetWorldTimes(0.f, 0.f, 0.f));
+		FSceneViewInitOptions viewInitOptions;
+		viewInitOptions.ViewFamily = &viewFamily;
+		viewInitOptions.SetViewRectangle(FIntRect(0, 0, 1920, 1080));
+		viewInitOptions.ViewOrigin = FVector(-2000.f, 0.f, 500.f);
+		viewInitOptions.ViewRotationMatrix = FInverseRotationMatrix(FRotator(-10.f, 0.f, 0.f)) * FMatrix(
+			FPlane(0, 0, 1, 0),
+			FPlane(1, 0, 0, 0),
+			FPlane(0, 1, 0, 0),
+			FPlane(0, 0, 0, 1));
+		viewInitOptions.ProjectionMatrix = FReversedZPerspectiveMatrix(FMath::DegreesToRadians(45.f), 1920.f, 1080.f, GNearClippingPlane);
+		// view family ʱdelete
+		FSceneView* view = new FSceneView(viewInitOptions);
+		viewFamily.Views.Add(view);
+
+		TArray<const FPrimitiveSceneProxy*> proxies;
+		for (const UDeformMeshComponent* deformCom : components)
+		{
+			proxies.Add(deformCom->SceneProxy);
+		}
+
+		const int32 numIterations = Options.ProxyIterations;
+		FDeformMeshBenchmarkResult* resultPtr = &result;
+		ENQUEUE_RENDER_COMMAND(FDeformMeshBenchmarkProxyIteration)(
+			[resultPtr, view, proxies, numIterations](FRHICommandListImmediate& RHICmdList)
+			{
+				resultPtr->ProxyIterationMs = 0.0;
+				resultPtr->ProxyBatchElements = 0;
+				for (const FPrimitiveSceneProxy* proxy : proxies)
+				{
+					int32 numBatchElements = 0;
+					resultPtr->ProxyIterationMs += TimeDeformMeshSectionIteration_RenderThread(proxy, *view, numIterations, numBatchElements);
+					resultPtr->ProxyBatchElements += numBatchElements;
+				}
+			});
+		FlushRenderingCommands();
+	}
+#pragma endregion
+
+#pragma region DestroyWorld
+	GEngine->DestroyWorldContext(world);
+	world->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+#pragma endregion
+
+	return result;
+}
+
+/** CSV еһʱ, bValid Ϊfalse ʱ, Ҫ0 ms һ */
+static FString TimesToCsv(const FDeformMeshBenchmarkTimes& Times, bool bWithPercentiles, bool bValid)
+{
+	if (!bValid)
+	{
+		return bWithPercentiles ? TEXT(",,,") : TEXT(",");
+	}
+	return bWithPercentiles ? FString::Printf(TEXT("%f,%f,%f,%f"), Times.Avg, Times.P50, Times.P95, Times.Max)
+		: FString::Printf(TEXT("%f,%f"), Times.Avg, Times.Max);
+}
+
+static FString ResultsToCsv(const TArray<FDeformMeshBenchmarkResult>& Results)
+{
+	FString csv = TEXT("Actors,SectionsPerActor,UpdateFraction,SectionsUpdatedPerFrame,Frames,SpawnMs,FirstFrameMs,ProxyReadyFrame,")
+		TEXT("GameThreadAvgMs,GameThreadP50Ms,GameThreadP95Ms,GameThreadMaxMs,")
+		TEXT("RenderThreadAvgMs,RenderThreadP50Ms,RenderThreadP95Ms,RenderThreadMaxMs,FlushAvgMs,FlushMaxMs,RenderScene,")
+		TEXT("ProxyIterationMs,ProxyBatchElements,AsyncProxyBuild\n");
+	for (const FDeformMeshBenchmarkResult& result : Results)
+	{
+		const FDeformMeshBenchmarkTimes gameThread = SummarizeTimes(result.GameThreadMs);
+		const FDeformMeshBenchmarkTimes renderThread = SummarizeTimes(result.RenderThreadMs);
+		const FDeformMeshBenchmarkTimes flush = SummarizeTimes(result.FlushMs);
+		// ûrender scene ʱProxyReadyFrame Ҳ
+		csv += FString::Printf(TEXT("%d,%d,%f,%d,%d,%f,%f,%s,%s,%s,%s,%d,"),
+			result.Config.NumActors, result.Config.NumSections, result.Config.UpdateFraction, result.SectionsUpdatedPerFrame,
+			result.GameThreadMs.Num(), result.SpawnMs, result.FirstFrameMs,
+			result.bHasRenderScene ? *FString::FromInt(result.ProxyReadyFrame) : TEXT(""),
+			*TimesToCsv(gameThread, true, true), *TimesToCsv(renderThread, true, result.bHasRenderScene),
+			*TimesToCsv(flush, false, result.bHasRenderScene), result.bHasRenderScene ? 1 : 0);
+		csv += result.ProxyIterationMs >= 0.0 ? FString::Printf(TEXT("%f,%d,"), result.ProxyIterationMs, result.ProxyBatchElements) : TEXT(",,");
+		csv += FString::Printf(TEXT("%d\n"), result.AsyncProxyBuild);
+	}
+	return csv;
+}
+
+static FString PerFrameToCsv(const TArray<FDeformMeshBenchmarkResult>& Results)
+{
+	FString csv = TEXT("Actors,SectionsPerActor,UpdateFraction,Frame,GameThreadMs,RenderThreadMs,FlushMs\n");
+	for (const FDeformMeshBenchmarkResult& result : Results)
+	{
+		for (int32 frame = 0; frame < result.GameThreadMs.Num(); frame++)
+		{
+			csv += FString::Printf(TEXT("%d,%d,%f,%d,%f,"),
+				result.Config.NumActors, result.Config.NumSections, result.Config.UpdateFraction, frame, result.GameThreadMs[frame]);
+			csv += result.bHasRenderScene ? FString::Printf(TEXT("%f,%f\n"), result.RenderThreadMs[frame], result.FlushMs[frame]) : TEXT(",\n");
+		}
+	}
+	return csv;
+}
+
+static FString TimesToJson(const TCHAR* Name, const TArray<double>& Times, bool bPerFrame, bool bValid = true)
+{
+	// JSON ûNaN, null
+	if (!bValid)
+	{
+		return FString::Printf(TEXT("\"%s\": null"), Name);
+	}
+
+	const FDeformMeshBenchmarkTimes summary = SummarizeTimes(Times);
+	FString json = FString::Printf(TEXT("\"%s\": {\"avg\": %f, \"p50\": %f, \"p95\": %f, \"max\": %f"),
+		Name, summary.Avg, summary.P50, summary.P95, summary.Max);
+	if (bPerFrame)
+	{
+		json += TEXT(", \"frames\": [");
+		for (int32 frame = 0; frame < Times.Num(); frame++)
+		{
+			json += FString::Printf(frame == 0 ? TEXT("%f") : TEXT(", %f"), Times[frame]);
+		}
+		json += TEXT("]");
+	}
+	return json + TEXT("}");
+}
+
+static FString ResultsToJson(const TArray<FDeformMeshBenchmarkResult>& Results, bool bPerFrame)
+{
+	// renderScene örender scene
+	const bool bAllHaveRenderScene = Results.Num() > 0 &&
+		!Results.ContainsByPredicate([](const FDeformMeshBenchmarkResult& Result) { return !Result.bHasRenderScene; });
+	FString json = FString::Printf(TEXT("{\n\t\"threadedRendering\": %s,\n\t\"renderScene\": %s,\n\t\"results\": [\n"),
+		GIsThreadedRendering ? TEXT("true") : TEXT("false"), bAllHaveRenderScene ? TEXT("true") : TEXT("false"));
+	for (int32 resultIndex = 0; resultIndex < Results.Num(); resultIndex++)
+	{
+		const FDeformMeshBenchmarkResult& result = Results[resultIndex];
+		json += FString::Printf(TEXT("\t\t{\"actors\": %d, \"sectionsPerActor\": %d, \"updateFraction\": %f, \"sectionsUpdatedPerFrame\": %d, ")
+			TEXT("\"frames\": %d, \"spawnMs\": %f, \"firstFrameMs\": %f, \"proxyReadyFrame\": %s, \"renderScene\": %s, \"asyncProxyBuild\": %d,\n\t\t\t"),
+			result.Config.NumActors, result.Config.NumSections, result.Config.UpdateFraction, result.SectionsUpdatedPerFrame,
+			result.GameThreadMs.Num(), result.SpawnMs, result.FirstFrameMs,
+			result.bHasRenderScene ? *FString::FromInt(result.ProxyReadyFrame) : TEXT("null"),
+			result.bHasRenderScene ? TEXT("true") : TEXT("false"), result.AsyncProxyBuild);
+		json += TimesToJson(TEXT("gameThreadMs"), result.GameThreadMs, bPerFrame) + TEXT(",\n\t\t\t");
+		json += TimesToJson(TEXT("renderThreadMs"), result.RenderThreadMs, bPerFrame, result.bHasRenderScene) + TEXT(",\n\t\t\t");
+		json += TimesToJson(TEXT("flushMs"), result.FlushMs, bPerFrame, result.bHasRenderScene) + TEXT(",\n\t\t\t");
+		json += result.ProxyIterationMs >= 0.0 ?
+			FString::Printf(TEXT("\"proxyIterationMs\": %f, \"proxyBatchElements\": %d"), result.ProxyIterationMs, result.ProxyBatchElements) :
+			FString(TEXT("\"proxyIterationMs\": null, \"proxyBatchElements\": null"));
+		json += resultIndex + 1 < Results.Num() ? TEXT("},\n") : TEXT("}\n");
+	}
+	return json + TEXT("\t]\n}\n");
+}
+
+UDeformMeshBenchmarkCommandlet::UDeformMeshBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Spawns deform mesh actors in a temporary world and records game and render thread frame times");
+	HelpUsage = TEXT("-run=DeformMeshBenchmark -nullrhi -Actors=1,16 -Sections=256,4096 -UpdateFractions=0.1,1 -Output=Saved/DeformMeshBenchmark.json ")
+		TEXT("(render thread columns are only filled with -AllowCommandletRendering -RenderOffscreen -RequireRenderScene instead of -nullrhi)");
+}
+
+int32 UDeformMeshBenchmarkCommandlet::Main(const FString& Params)
+{
+#pragma region ParseOptions
+	FDeformMeshBenchmarkOptions options;
+	ParseList(Params, TEXT("Actors="), options.ActorCounts);
+	ParseList(Params, TEXT("Sections="), options.SectionCounts);
+	ParseList(Params, TEXT("UpdateFractions="), options.UpdateFractions);
+	FParse::Value(*Params, TEXT("Frames="), options.Frames);
+	FParse::Value(*Params, TEXT("WarmupFrames="), options.WarmupFrames);
+	FParse::Value(*Params, TEXT("Seed="), options.Seed);
+	FParse::Value(*Params, TEXT("Mesh="), options.MeshPath);
+	options.bPerFrame = FParse::Param(*Params, TEXT("PerFrame"));
+	options.bRequireRenderScene = FParse::Param(*Params, TEXT("RequireRenderScene"));
+	FParse::Value(*Params, TEXT("ProxyIterations="), options.ProxyIterations);
+	options.bCompareAsyncProxyBuild = FParse::Param(*Params, TEXT("CompareAsyncProxyBuild"));
+	if (!FParse::Value(*Params, TEXT("Output="), options.OutputPath))
+	{
+		options.OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DeformMeshBenchmark.csv"));
+	}
+	options.Frames = FMath::Max(options.Frames, 1);
+	options.WarmupFrames = FMath::Max(options.WarmupFrames, 0);
+#pragma endregion
+
+	UStaticMesh* mesh = LoadObject<UStaticMesh>(nullptr, *options.MeshPath);
+	if (mesh == nullptr)
+	{
+		UE_LOG(LogDeformMeshBenchmark, Error, TEXT("Can not load static mesh %s"), *options.MeshPath);
+		return 1;
+	}
+
+	TArray<FDeformMeshBenchmarkResult> results;
+	for (int32 numActors : options.ActorCounts)
+	{
+		for (int32 numSections : options.SectionCounts)
+		{
+			for (float updateFraction : options.UpdateFractions)
+			{
+				FDeformMeshBenchmarkConfig config;
+				config.NumActors = FMath::Max(numActors, 1);
+				config.NumSections = FMath::Max(numSections, 1);
+				config.UpdateFraction = FMath::Clamp(updateFraction, 0.f, 1.f);
+
+				// ͬú, ֻproxy build ķʽͬ
+				if (options.bCompareAsyncProxyBuild)
+				{
+					IConsoleVariable* asyncProxyBuild = IConsoleManager::Get().FindConsoleVariable(TEXT("r.DeformMesh.AsyncProxyBuild"));
+					const int32 asyncThreshold = asyncProxyBuild->GetInt();
+					asyncProxyBuild->Set(0, ECVF_SetByCode);
+					const FDeformMeshBenchmarkResult syncResult = RunBenchmarkConfig(config, options, mesh);
+					asyncProxyBuild->Set(asyncThreshold, ECVF_SetByCode);
+					results.Add(syncResult);
+
+					UE_LOG(LogDeformMeshBenchmark, Display, TEXT("actors %d sections %d update %.2f: AsyncProxyBuild=0 spawn %.2f ms, first frame %.2f ms, proxies ready at frame %d"),
+						config.NumActors, config.NumSections, config.UpdateFraction,
+						syncResult.SpawnMs, syncResult.FirstFrameMs, syncResult.ProxyReadyFrame);
+				}
+
+				const FDeformMeshBenchmarkResult& result = results.Add_GetRef(RunBenchmarkConfig(config, options, mesh));
+				const FDeformMeshBenchmarkTimes gameThread = SummarizeTimes(result.GameThreadMs);
+				if (!result.bHasRenderScene)
+				{
+					if (options.bRequireRenderScene)
+					{
+						UE_LOG(LogDeformMeshBenchmark, Error, TEXT("-RequireRenderScene: the benchmark world has no render scene. ")
+							TEXT("Run with -AllowCommandletRendering -RenderOffscreen instead of -nullrhi."));
+						return 1;
+					}
+					UE_LOG(LogDeformMeshBenchmark, Display, TEXT("actors %d sections %d update %.2f: spawn %.2f ms, game thread avg %.3f p95 %.3f ms, no render scene"),
+						config.NumActors, config.NumSections, config.UpdateFraction, result.SpawnMs, gameThread.Avg, gameThread.P95);
+					continue;
+				}
+
+				const FDeformMeshBenchmarkTimes renderThread = SummarizeTimes(result.RenderThreadMs);
+				UE_LOG(LogDeformMeshBenchmark, Display, TEXT("actors %d sections %d update %.2f: spawn %.2f ms, proxies ready at frame %d, game thread avg %.3f p95 %.3f ms, render thread avg %.3f p95 %.3f ms"),
+					config.NumActors, config.NumSections, config.UpdateFraction, result.SpawnMs, result.ProxyReadyFrame,
+					gameThread.Avg, gameThread.P95, renderThread.Avg, renderThread.P95);
+				if (options.bCompareAsyncProxyBuild)
+				{
+					const FDeformMeshBenchmarkResult& syncResult = results[results.Num() - 2];
+					UE_LOG(LogDeformMeshBenchmark, Display, TEXT("    AsyncProxyBuild=%d vs 0: spawn %+.2f ms, first frame %+.2f ms, proxies ready %+d frames"),
+						result.AsyncProxyBuild, result.SpawnMs - syncResult.SpawnMs, result.FirstFrameMs - syncResult.FirstFrameMs,
+						result.ProxyReadyFrame - syncResult.ProxyReadyFrame);
+				}
+				if (result.ProxyIterationMs >= 0.0)
+				{
+					UE_LOG(LogDeformMeshBenchmark, Display, TEXT("    proxy section iteration %.4f ms, %d batch elements"),
+						result.ProxyIterationMs, result.ProxyBatchElements);
+				}
+			}
+		}
+	}
+
+	// ÿRunBenchmarkConfig аԼworld ж, Ҳü¼
+	if (results.ContainsByPredicate([](const FDeformMeshBenchmarkResult& Result) { return !Result.bHasRenderScene; }))
+	{
+		UE_LOG(LogDeformMeshBenchmark, Warning, TEXT("Some configs had no render scene (-nullrhi), deform mesh proxies were not created and ")
+			TEXT("their render thread columns are left empty. Use -AllowCommandletRendering -RenderOffscreen to measure them."));
+	}
+
+#pragma region WriteOutput
+	const bool bJson = FPaths::GetExtension(options.OutputPath).Equals(TEXT("json"), ESearchCase::IgnoreCase);
+	const FString output = bJson ? ResultsToJson(results, options.bPerFrame) : ResultsToCsv(results);
+	if (!FFileHelper::SaveStringToFile(output, *options.OutputPath))
+	{
+		UE_LOG(LogDeformMeshBenchmark, Error, TEXT("Can not write %s"), *options.OutputPath);
+		return 1;
+	}
+	UE_LOG(LogDeformMeshBenchmark, Display, TEXT("Wrote %s"), *options.OutputPath);
+
+	// JSON ÿ֡ʱڽ, CSV һļ
+	if (options.bPerFrame && !bJson)
+	{
+		const FString perFramePath = FPaths::Combine(FPaths::GetPath(options.OutputPath),
+			FPaths::GetBaseFilename(options.OutputPath) + TEXT("_frames.csv"));
+		if (!FFileHelper::SaveStringToFile(PerFrameToCsv(results), *perFramePath))
+		{
+			UE_LOG(LogDeformMeshBenchmark, Error, TEXT("Can not write %s"), *perFramePath);
+			return 1;
+		}
+		UE_LOG(LogDeformMeshBenchmark, Display, TEXT("Wrote %s"), *perFramePath);
+	}
+#pragma endregion
+
+	return 0;
+}
@@ -23,16 +23,280 @@
 #include "RHIDefinitions.h"
 #include "SceneView.h"
 #include "SceneInterface.h"
+#include "UniformBuffer.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+#include "UObject/UObjectIterator.h"
+#include "Async/TaskGraphInterfaces.h"
+
+#include "DeformMeshStats.h"
+#include "DeformMeshRendering.h"
+#include "DeformMeshPreDeform.h"
+#include "DeformMeshDeformers.h"
+#include "DeformMeshTransformPool.h"
+#include "DeformMeshUpdateQueue.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDeformMesh, Log, All);
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cached Mesh Batches"), STAT_DeformMeshCachedBatches, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dynamic Mesh Batches"), STAT_DeformMeshDynamicBatches, STATGROUP_DeformMesh);
+DECLARE_MEMORY_STAT(TEXT("Index Buffer Memory Saved"), STAT_DeformMeshIndexBytesSaved, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Triangles LOD0"), STAT_DeformMeshTrianglesLOD0, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Triangles LOD1"), STAT_DeformMeshTrianglesLOD1, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Triangles LOD2"), STAT_DeformMeshTrianglesLOD2, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Triangles LOD3+"), STAT_DeformMeshTrianglesLOD3Plus, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Tested"), STAT_DeformMeshSectionsTested, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Culled"), STAT_DeformMeshSectionsCulled, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Drawn"), STAT_DeformMeshSectionsDrawn, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PreDeform Dispatches"), STAT_DeformMeshPreDeformDispatches, STATGROUP_DeformMesh);
+DECLARE_MEMORY_STAT(TEXT("PreDeformed Position Memory"), STAT_DeformMeshPreDeformedBytes, STATGROUP_DeformMesh);
+DECLARE_MEMORY_STAT(TEXT("Proxy CPU Memory"), STAT_DeformMeshProxyCPUBytes, STATGROUP_DeformMesh);
+DECLARE_MEMORY_STAT(TEXT("Proxy GPU Memory"), STAT_DeformMeshProxyGPUBytes, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Proxy Build"), STAT_DeformMeshProxyBuild, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Create Scene Proxy"), STAT_DeformMeshCreateSceneProxy, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Proxy Builds"), STAT_DeformMeshAsyncProxyBuilds, STATGROUP_DeformMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sections"), STAT_DeformMeshSections, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Update Records Drained"), STAT_DeformMeshUpdateRecords, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Drain Update Queue RT"), STAT_DeformMeshDrainUpdateQueue, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Compact Slots RT"), STAT_DeformMeshCompactSlots, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Added In Place"), STAT_DeformMeshSectionsAddedInPlace, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sections Removed In Place"), STAT_DeformMeshSectionsRemovedInPlace, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Slot Compactions"), STAT_DeformMeshSlotCompactions, STATGROUP_DeformMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Empty Transform Slots"), STAT_DeformMeshEmptySlots, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Section Transform"), STAT_DeformMeshUpdateSectionTransform, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Section Transforms"), STAT_DeformMeshUpdateSectionTransforms, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Section Transforms Batched"), STAT_DeformMeshUpdateSectionTransformsBatched, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Update Local Bounds"), STAT_DeformMeshUpdateLocalBounds, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Get Dynamic Mesh Elements"), STAT_DeformMeshGetDynamicMeshElements, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Upload Transforms RT"), STAT_DeformMeshUploadTransforms, STATGROUP_DeformMesh);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshCacheStaticDraw(
+	TEXT("r.DeformMesh.CacheStaticDraw"),
+	1,
+	TEXT("Whether deform mesh sections are drawn through cached mesh draw commands.\n")
+	TEXT(" 0: rebuild mesh batches every frame in GetDynamicMeshElements\n")
+	TEXT(" 1: cache mesh batches in DrawStaticElements, only re-cached when sections change (default)\n")
+	TEXT("The cached path saves building mesh batches every frame, but the whole component is culled and\n")
+	TEXT("picks one LOD by its total bounds: per-section frustum/distance culling, per-section LOD and the\n")
+	TEXT("Sections Tested/Culled/Drawn and Triangles LODn stats only apply to the dynamic path.\n")
+	TEXT("Components with more than r.DeformMesh.CacheStaticDrawMaxSections sections, or whose sections are spread\n")
+	TEXT("out further than r.DeformMesh.CacheStaticDrawMaxSpread, use the dynamic path even when this is 1.\n")
+	TEXT("Takes effect when the deform mesh render state is recreated."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshCacheStaticDrawMaxSections(
+	TEXT("r.DeformMesh.CacheStaticDrawMaxSections"),
+	256,
+	TEXT("Deform mesh components with more sections than this always use the dynamic path, where sections\n")
+	TEXT("outside the view are culled before any mesh batch is built. 0 means no limit."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<float> CVarDeformMeshCacheStaticDrawMaxSpread(
+	TEXT("r.DeformMesh.CacheStaticDrawMaxSpread"),
+	8.f,
+	TEXT("Deform mesh components switch to the dynamic path when the radius of the box around all sections is\n")
+	TEXT("larger than this many times the largest section radius, since then most of the component is usually\n")
+	TEXT("off screen or far away. Switching back happens below 80% of it. 0 means no limit.\n")
+	TEXT("Re-evaluated when sections move, are added or removed."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshUpdateQueueDrainThreshold(
+	TEXT("r.DeformMesh.UpdateQueueDrainThreshold"),
+	65536,
+	TEXT("Section updates are queued for the render thread, which drains the queue once before each view family renders.\n")
+	TEXT("After this many updates from the game thread a render command also drains it, so the queue stays bounded\n")
+	TEXT("when nothing is rendered."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshInPlaceSectionChanges(
+	TEXT("r.DeformMesh.InPlaceSectionChanges"),
+	1,
+	TEXT("Whether CreateSection and ClearSection change the live deform mesh proxy in place.\n")
+	TEXT(" 0: every section change recreates the render state and rebuilds all sections\n")
+	TEXT(" 1: only the changed section's transform slot (and vertex factory, for a new static mesh) is created or freed (default)\n")
+	TEXT("Adding sections with r.DeformMesh.PreDeform always recreates the render state."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarDeformMeshSlotCompaction(
+	TEXT("r.DeformMesh.SlotCompaction"),
+	0.25f,
+	TEXT("Fraction of a deform mesh proxy's transform slots that may be left empty by removed sections before the\n")
+	TEXT("remaining sections are moved together and the pooled transform range shrunk. At least 16 empty slots are\n")
+	TEXT("always tolerated. 0 disables automatic compaction, UDeformMeshComponent::CompactSections still compacts."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshTransformBufferDepth(
+	TEXT("r.DeformMesh.TransformBufferDepth"),
+	3,
+	TEXT("Number of per-frame slices in each deform mesh transform buffer (1-4).\n")
+	TEXT("Each frame's transforms are written into the slice after the one the GPU read last frame, so the\n")
+	TEXT("previous frame's transforms stay in place for velocity. This is not a no-overwrite stream: the upload\n")
+	TEXT("itself is a scatter copy on the GPU (a whole-page lock of a dynamic buffer below SM5), which is safe with\n")
+	TEXT("any depth. With 1 there are no previous transforms and section transform changes draw no velocity.\n")
+	TEXT("Takes effect when the deform mesh render state is recreated."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshParallelCullMinSections(
+	TEXT("r.DeformMesh.ParallelCullMinSections"),
+	512,
+	TEXT("Deform mesh components with at least this many sections cull and select LODs for their sections\n")
+	TEXT("in a ParallelFor. Smaller components do it on the render thread."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshTransformEncoding(
+	TEXT("r.DeformMesh.TransformEncoding"),
+	1,
+	TEXT("How deform transforms are stored in the DMTransforms buffer.\n")
+	TEXT(" 0: full 4x4 matrix, 64 bytes per section\n")
+	TEXT(" 1: 3x4 affine matrix, 48 bytes per section, lossless for deform transforms (default)\n")
+	TEXT(" 2: translation + scale + 16 bit quaternion, 32 bytes per section, no shear\n")
+	TEXT("Changes the deform mesh vertex factory shaders, so it can only be set at startup and needs a shader recompile."),
+	ECVF_ReadOnly | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshPreDeform(
+	TEXT("r.DeformMesh.PreDeform"),
+	0,
+	TEXT("Whether deform mesh vertices are deformed once by a compute shader when transforms change.\n")
+	TEXT(" 0: every vertex shader (base pass, depth, shadow, velocity ...) applies the deform transform (default)\n")
+	TEXT(" 1: a compute pass writes world space positions of every section and LOD into a buffer,\n")
+	TEXT("    the vertex factory only loads them. Costs 12 bytes per vertex per section per LOD, SM5 only.\n")
+	TEXT("Changes the deform mesh vertex factory shaders, so it can only be set at startup and needs a shader recompile."),
+	ECVF_ReadOnly | ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshAsyncProxyBuild(
+	TEXT("r.DeformMesh.AsyncProxyBuild"),
+	256,
+	TEXT("Deform mesh components with at least this many sections build the CPU side proxy data\n")
+	TEXT("(grouping, transform slots, encoded transforms) on the task graph and draw nothing until it is done.\n")
+	TEXT("Smaller components and 0 build it on the game thread in CreateSceneProxy."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshDeformers(
+	TEXT("r.DeformMesh.Deformers"),
+	0,
+	TEXT("Bitmask of the non-rigid deformer kinds the project uses, each one is a set of vertex factory\n")
+	TEXT("and pre deform shader permutations. Sections with a disabled kind are drawn rigid.\n")
+	TEXT(" 1: bend, 2: twist, 4: taper, 8: lattice (default 0, rigid only)\n")
+	TEXT("Changes which shaders are compiled, so it can only be set at startup."),
+	ECVF_ReadOnly | ECVF_RenderThreadSafe);
+
+EDeformTransformEncoding GetDeformTransformEncoding()
+{
+	return (EDeformTransformEncoding)FMath::Clamp(CVarDeformMeshTransformEncoding.GetValueOnAnyThread(), 0, 2);
+}
+
+bool IsDeformMeshPreDeformEnabled(EShaderPlatform Platform)
+{
+	return CVarDeformMeshPreDeform.GetValueOnAnyThread() != 0 &&
+		IsFeatureLevelSupported(Platform, ERHIFeatureLevel::SM5);
+}
+
+bool IsDeformMeshDeformerEnabled(EDeformMeshDeformerKind Kind)
+{
+	if (Kind == EDeformMeshDeformerKind::Rigid)
+	{
+		return true;
+	}
+	// Bend bit 0
+	const int32 bit = 1 << ((int32)Kind - 1);
+	return (CVarDeformMeshDeformers.GetValueOnAnyThread() & bit) != 0;
+}
+
+int32 GetDeformTransformStride(EDeformTransformEncoding Encoding)
+{
+	switch (Encoding)
+	{
+	case EDeformTransformEncoding::Affine3x4: return 3;
+	case EDeformTransformEncoding::QuatTranslationScale: return 2;
+	default: return 4;
+	}
+}
+
+static uint32 PackSnorm16x2(float X, float Y)
+{
+	const int16 x = (int16)FMath::RoundToInt(FMath::Clamp(X, -1.f, 1.f) * 32767.f);
+	const int16 y = (int16)FMath::RoundToInt(FMath::Clamp(Y, -1.f, 1.f) * 32767.f);
+	return (uint32)(uint16)x | ((uint32)(uint16)y << 16);
+}
+
+/**
+ * section deform transform GetDeformTransformStride float4, DeformMeshCommon.ush LoadDeformTransform
+ * DeformTransform ϴ4x4 һתù
+ */
+static void EncodeDeformTransform(EDeformTransformEncoding Encoding, const FMatrix& DeformTransform, FVector4* OutData)
+{
+	switch (Encoding)
+	{
+	case EDeformTransformEncoding::Matrix4x4:
+	case EDeformTransformEncoding::Affine3x4:
+	{
+		// 3x4 ֻȥһ, 任תúһ(0, 0, 0, 1)
+		const int32 numRows = GetDeformTransformStride(Encoding);
+		for (int32 row = 0; row < numRows; row++)
+		{
+			OutData[row] = FVector4(DeformTransform.M[row][0], DeformTransform.M[row][1],
+				DeformTransform.M[row][2], DeformTransform.M[row][3]);
+		}
+		break;
+	}
+	case EDeformTransformEncoding::QuatTranslationScale:
+	{
+		// (translation, scale.x) (scale.y, scale.z, quaternion.xy, quaternion.zw)
+		const FTransform transform(DeformTransform.GetTransposed());
+		const FQuat rotation = transform.GetRotation().GetNormalized();
+		const FVector translation = transform.GetTranslation();
+		const FVector scale = transform.GetScale3D();
+
+		OutData[0] = FVector4(translation, scale.X);
+		OutData[1] = FVector4(scale.Y, scale.Z, 0.f, 0.f);
+		// quaternion bit ںfloat , shader asuint ȡ
+		uint32* packedRotation = reinterpret_cast<uint32*>(&OutData[1].Z);
+		packedRotation[0] = PackSnorm16x2(rotation.X, rotation.Y);
+		packedRotation[1] = PackSnorm16x2(rotation.Z, rotation.W);
+		break;
+	}
+	}
+}
+
+// GetDynamicMeshElements б޳صsection LOD 
+static constexpr uint8 DeformSectionCulled = 0xFF;
+
+/**
+ * Deform mesh vertex factory uniform buffer
+ * TransformBaseIndex ǵǰ֡slice DMTransforms еʼλ, ÿֵֻ֡,
+ * uniform buffer , cached mesh draw command Ҫؽ
+ * PrevTransformBaseIndex һ֡slice, лslice ൱ڽcurrent/previous buffer, һ֡transform Ҫϴ
+ * л֮һ֡ûиʱproxy ĳɺTransformBaseIndex ͬ, shader Ҫ֪һ֡
+ */
+BEGIN_GLOBAL_SHADER_PARAMETER_STRUCT(FDeformMeshVFUniformParameters, )
+	SHADER_PARAMETER(uint32, TransformBaseIndex)
+	SHADER_PARAMETER(uint32, PrevTransformBaseIndex)
+END_GLOBAL_SHADER_PARAMETER_STRUCT()
+IMPLEMENT_GLOBAL_SHADER_PARAMETER_STRUCT(FDeformMeshVFUniformParameters, "DeformMeshVF");
 
 
 class FDeformMeshSceneProxy;
-class FDeformMeshSectionProxy;
+struct FDeformMeshSectionProxy;
 class FDeformMeshVertexFactoryShaderParameters;
 struct FDeformMeshVertexFactory;
 
 static void InitVertexFactoryData(FDeformMeshVertexFactory* VertexFactory,
 	FStaticMeshVertexBuffers* VertexBuffer);
 
+/**
+ * LOD ͳdynamic path , LOD3 Ϻϲͳ
+ */
+static void IncDeformMeshTrianglesStat(int32 LODIndex, uint32 NumTriangles)
+{
+	switch (LODIndex)
+	{
+	case 0: INC_DWORD_STAT_BY(STAT_DeformMeshTrianglesLOD0, NumTriangles); break;
+	case 1: INC_DWORD_STAT_BY(STAT_DeformMeshTrianglesLOD1, NumTriangles); break;
+	case 2: INC_DWORD_STAT_BY(STAT_DeformMeshTrianglesLOD2, NumTriangles); break;
+	default: INC_DWORD_STAT_BY(STAT_DeformMeshTrianglesLOD3Plus, NumTriangles); break;
+	}
+}
+
 /**
  * Defrom Mesh Component vertex factory
  * 
@@ -77,6 +341,8 @@ public:
 		}
 
 		OutEnvironment.SetDefine(TEXT("DEFORM_MESH"), TEXT("1"));
+		OutEnvironment.SetDefine(TEXT("DEFORM_MESH_TRANSFORM_ENCODING"), (uint32)GetDeformTransformEncoding());
+		OutEnvironment.SetDefine(TEXT("DEFORM_MESH_PREDEFORMED"), IsDeformMeshPreDeformEnabled(Parameters.Platform) ? 1 : 0);
 	}
 
 
@@ -95,18 +361,29 @@ public:
 
 		FVertexDeclarationElementList elements;  // used for default vertex stream
 		FVertexDeclarationElementList posOnlyElements; // position only vertex stream
+		FVertexDeclarationElementList posAndNormalElements; // shadow depth pass 
 
 		if (Data.PositionComponent.VertexBuffer != NULL)
 		{
 			//AccessStreamComponent  vertexStreamComponentһvertexElement
 			elements.Add(AccessStreamComponent(Data.PositionComponent, 0));  
-			posOnlyElements.Add(AccessStreamComponent(Data.PositionComponent, 0));
+			// ӵӦ͵stream , SupportsPositionOnlyStream false, depth pass position only shader
+			posOnlyElements.Add(AccessStreamComponent(Data.PositionComponent, 0, EVertexInputStreamType::PositionOnly));
+			posAndNormalElements.Add(AccessStreamComponent(Data.PositionComponent, 0, EVertexInputStreamType::PositionAndNormalOnly));
 		}
 
 		// ʼposition only declarationdepth passõ 
 		// ӵPipelineStateCache::GetOrCreateVertexDeclartion  RHIddeclartion
 		InitDeclaration(posOnlyElements, EVertexInputStreamType::PositionOnly);
 
+		// shadow depth pass position and normal only declaration, normal ATTRIBUTE2
+		// shader deform transform ת䵽world space, slope scaled depth bias 
+		if (Data.TangentBasisComponents[1].VertexBuffer != NULL)
+		{
+			posAndNormalElements.Add(AccessStreamComponent(Data.TangentBasisComponents[1], 2, EVertexInputStreamType::PositionAndNormalOnly));
+			InitDeclaration(posAndNormalElements, EVertexInputStreamType::PositionAndNormalOnly);
+		}
+
 		// texcoords to default elements,unlit shading 㹻
 		if (Data.TextureCoordinates.Num())
 		{
@@ -136,371 +413,2320 @@ public:
 	}
 
 
-	inline void SetTransformIndex(uint16 val) { TransformIndex = val; }
 	inline void SetSceneProxy(FDeformMeshSceneProxy* val) { SceneProxy = val; }
 private:
 
-	// shaderȡtransform 
-	uint16 TransformIndex;
-
 	// ȡcomponent prxy unified shader resource view
 	FDeformMeshSceneProxy* SceneProxy;
 
 	friend class FDeformMeshVertexFactoryShaderParameters;
 };
 
+/**
+ * Rigid deformer vertex factory, UE4 vertex factory ûpermutation domain,
+ * ÿdeformer һvertex factory type, ֻ DEFORM_MESH_DEFORMER 
+ */
+template<EDeformMeshDeformerKind Kind>
+struct TDeformMeshDeformerVertexFactory : public FDeformMeshVertexFactory
+{
+	TDeformMeshDeformerVertexFactory(ERHIFeatureLevel::Type InFeatureLevel)
+		: FDeformMeshVertexFactory(InFeatureLevel)
+	{
+	}
+
+	// û r.DeformMesh.Deformers д򿪵಻
+	static bool ShouldCompilePermutation(const FVertexFactoryShaderPermutationParameters& Parameters)
+	{
+		return IsDeformMeshDeformerEnabled(Kind) && FDeformMeshVertexFactory::ShouldCompilePermutation(Parameters);
+	}
+
+	static void ModifyCompilationEnvironment(const FVertexFactoryShaderPermutationParameters& Parameters,
+		FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FDeformMeshVertexFactory::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("DEFORM_MESH_DEFORMER"), (uint32)Kind);
+	}
+};
+
+struct FDeformMeshBendVertexFactory : public TDeformMeshDeformerVertexFactory<EDeformMeshDeformerKind::Bend>
+{
+	DECLARE_VERTEX_FACTORY_TYPE(FDeformMeshBendVertexFactory);
+public:
+	using TDeformMeshDeformerVertexFactory::TDeformMeshDeformerVertexFactory;
+};
+
+struct FDeformMeshTwistVertexFactory : public TDeformMeshDeformerVertexFactory<EDeformMeshDeformerKind::Twist>
+{
+	DECLARE_VERTEX_FACTORY_TYPE(FDeformMeshTwistVertexFactory);
+public:
+	using TDeformMeshDeformerVertexFactory::TDeformMeshDeformerVertexFactory;
+};
+
+struct FDeformMeshTaperVertexFactory : public TDeformMeshDeformerVertexFactory<EDeformMeshDeformerKind::Taper>
+{
+	DECLARE_VERTEX_FACTORY_TYPE(FDeformMeshTaperVertexFactory);
+public:
+	using TDeformMeshDeformerVertexFactory::TDeformMeshDeformerVertexFactory;
+};
+
+struct FDeformMeshLatticeVertexFactory : public TDeformMeshDeformerVertexFactory<EDeformMeshDeformerKind::Lattice>
+{
+	DECLARE_VERTEX_FACTORY_TYPE(FDeformMeshLatticeVertexFactory);
+public:
+	using TDeformMeshDeformerVertexFactory::TDeformMeshDeformerVertexFactory;
+};
+
+/** deformer ഴvertex factory, Kind Ѿ */
+static FDeformMeshVertexFactory* CreateDeformMeshVertexFactory(EDeformMeshDeformerKind Kind, ERHIFeatureLevel::Type FeatureLevel)
+{
+	switch (Kind)
+	{
+	case EDeformMeshDeformerKind::Bend: return new FDeformMeshBendVertexFactory(FeatureLevel);
+	case EDeformMeshDeformerKind::Twist: return new FDeformMeshTwistVertexFactory(FeatureLevel);
+	case EDeformMeshDeformerKind::Taper: return new FDeformMeshTaperVertexFactory(FeatureLevel);
+	case EDeformMeshDeformerKind::Lattice: return new FDeformMeshLatticeVertexFactory(FeatureLevel);
+	default: return new FDeformMeshVertexFactory(FeatureLevel);
+	}
+}
+
 
 
 
-class FDeformMeshSectionProxy
+/**
+ * static mesh һLOD render resource
+ */
+class FDeformMeshSourceLOD
 {
 public:
-	FDeformMeshSectionProxy(ERHIFeatureLevel::Type InFeatureLevel)
-		: SectionMaterial(nullptr)
-		, VertexFactory(InFeatureLevel)
-		, bSectionVisible(true)
+	FDeformMeshSourceLOD()
+		: IndexBuffer(nullptr)
+		, PositionBuffer(nullptr)
+		, MaxVertexIndex(0)
+		, NumPrimitives(0)
+		, ScreenSize(0.f)
 	{
 	}
 
-	// ǰsection Ĳ
-	UMaterialInterface* SectionMaterial = nullptr;
+	// ֱstatic mesh LOD index buffer, , Ҳͷ
+	// vertex factory õvertex buffer һ, static mesh render data ֤
+	const FRawStaticIndexBuffer* IndexBuffer;
 
-	FRawStaticIndexBuffer IndexBuffer;
+	// pre deform , ͬstatic mesh
+	FPositionVertexBuffer* PositionBuffer;
 
-	FDeformMeshVertexFactory VertexFactory;
+	// source deformer ഴ, ûstream in LOD ǿյ
+	TUniquePtr<FDeformMeshVertexFactory> VertexFactory;
 
-	bool bSectionVisible;
 	/* Max vertix index is an info that 
 	* is needed when rendering the mesh, so we 
 	* cache it here so we don't have to pointer chase it later
 	*/
 	uint32 MaxVertexIndex;
-};
 
+	// ͬ, ÿ֡ȥstatic mesh index buffer
+	uint32 NumPrimitives;
+
+	// static mesh õLOD screen size, ĻߴСʱʹLOD ͵LOD
+	float ScreenSize;
+};
 
-class FDeformMeshSceneProxy final : public FPrimitiveSceneProxy
+/**
+ * ʹͬһstatic mesh section õrender resource, ÿLOD һ
+ */
+class FDeformMeshSourceProxy
 {
 public:
-	SIZE_T GetTypeHash() const override
+	FDeformMeshSourceProxy()
+		: MinLOD(0)
+		, DeformerKind(EDeformMeshDeformerKind::Rigid)
 	{
-		static size_t UniquePointer;
-		return reinterpret_cast<size_t>(&UniquePointer);
 	}
 
-	FDeformMeshSceneProxy(UDeformMeshComponent* deformCom)
-		: FPrimitiveSceneProxy(deformCom)
-		, MaterialRelevance(deformCom->GetMaterialRelevance(GetScene().GetFeatureLevel()))
-	{
-		const uint16 numSections = deformCom->DeformMeshSections.Num();
+	TIndirectArray<FDeformMeshSourceLOD> LODs;
 
-		DeformTransforms.AddZeroed(numSections);
-		Sections.AddZeroed(numSections);
+	// Ѿstream in ĵһLOD, ߾ȵLOD ûrender resource
+	int32 MinLOD;
 
-		Sections.Reserve(numSections);
-#pragma region CreateSectionProxies
-		for (uint16 sectionIndex = 0; sectionIndex < numSections; sectionIndex++)
+	// static mesh local bounds, section Ļߴ
+	FBoxSphereBounds Bounds;
+
+	// vertex factory , ͬһstatic mesh Ĳͬdeformer ǲͬsource
+	EDeformMeshDeformerKind DeformerKind;
+
+	// ֻΪlive proxy section ʱsource key, render thread 
+	UStaticMesh* StaticMesh = nullptr;
+
+	// ʹsource section , 0 ʱͷvertex factory
+	int32 NumLiveSlots = 0;
+
+	/**
+	 * ÿsection ֱõstatic mesh index buffer ĴС, Ҳÿsection ٸƵڴ
+	 * ֻrender resource LOD, index buffer ʵʵ16/32 bit ʽ
+	 */
+	uint32 GetSharedIndexBytes() const
+	{
+		uint32 indexBytes = 0;
+		for (int32 lodIndex = MinLOD; lodIndex < LODs.Num(); lodIndex++)
 		{
-			const FDeformMeshSection& srcSection = deformCom->DeformMeshSections[sectionIndex];
-			// ͳʼsection proxy
+			const FRawStaticIndexBuffer* indexBuffer = LODs[lodIndex].IndexBuffer;
+			if (indexBuffer != nullptr)
 			{
-				FDeformMeshSectionProxy* newSectionProxy = new FDeformMeshSectionProxy(
-					GetScene().GetFeatureLevel());
-				//srcSection.StaticMesh->RenderData->LODResources[0]
-
-				auto& LODResource = srcSection.StaticMesh->RenderData->LODResources[0];
+				indexBytes += indexBuffer->GetNumIndices() * (indexBuffer->Is32Bit() ? sizeof(uint32) : sizeof(uint16));
+			}
+		}
+		return indexBytes;
+	}
+};
 
-				FDeformMeshVertexFactory* vertexFactory = &newSectionProxy->VertexFactory;
+/**
+ * mesh batch element UserData, ÿgroup ÿLOD һ
+ */
+struct FDeformMeshBatchUserData
+{
+	// slot 0 PreDeformedPositions еλ, λǶ
+	// section λô PreDeformedBase + FirstSlot * NumVertices ʼ, ԿǸ
+	int32 PreDeformedBase;
 
-				// static meshеֵʼvertex factory
-				InitVertexFactoryData(vertexFactory, &(LODResource.VertexBuffers));
+	// slot 0 ĲDeformerParams еλ, ͬǸ, Rigid ʱʹ
+	int32 DeformerParamBase;
+};
 
-				vertexFactory->SetTransformIndex(sectionIndex);
-				vertexFactory->SetSceneProxy(this);
+/**
+ * source mesh Ͳʶͬһsection
+ * ǵtransform DeformTransforms , һinstanced draw ܻ,
+ * shader  instance id + DMTransformIndex transform λ
+ */
+struct FDeformMeshSectionGroup
+{
+	FDeformMeshSourceProxy* Source;
 
-				// static meshindex bufferʹmesh sectionindex buffer
-				{
-					TArray<uint32> tmp_indices;
-					LODResource.IndexBuffer.GetCopy(tmp_indices);
-					newSectionProxy->IndexBuffer.AppendIndices(tmp_indices.GetData(),
-						tmp_indices.Num());
-					// 
-					BeginInitResource(&newSectionProxy->IndexBuffer);
-				}
+	UMaterialInterface* Material;
 
+	// section DeformTransforms е [FirstSlot, FirstSlot + NumSlots), ûпslot
+	// ɾsection ֮һgroup ֮пslot, ͬmesh Ͳʵsection ʱʹ
+	int32 FirstSlot;
+	int32 NumSlots;
 
-				DeformTransforms[sectionIndex] = srcSection.DeformTransform;
+	// mesh batch element UserData ָ
+	FDeformMeshBatchUserData BatchUserData[MAX_STATIC_MESH_LODS];
+};
 
-				// section maxVertexIndex
-				newSectionProxy->MaxVertexIndex =
-					LODResource.VertexBuffers.PositionVertexBuffer.GetNumVertices() - 1;
+/**
+ * proxy еsection ֻ¼ĸgroup, Լtransform slot,
+ * render thread ÿ֡Ҫ (transform, ɼ, bounds ...) ڰslot еĲ
+ * ֵSections , ûStaticMesh section TransformSlot INDEX_NONE
+ */
+struct FDeformMeshSectionProxy
+{
+	// ڵFDeformMeshSectionGroup
+	int32 GroupIndex = INDEX_NONE;
 
-				newSectionProxy->SectionMaterial = deformCom->GetMaterial(sectionIndex);
+	// section transform DeformTransforms еλ, ͬʱҲSlotVisible 
+	int32 TransformSlot = INDEX_NONE;
 
-				if (newSectionProxy->SectionMaterial == nullptr)
-				{
-					newSectionProxy->SectionMaterial = UMaterial::GetDefaultMaterial(MD_Surface);
-				}
+	// section ʱInPlaceSectionSerial, ļ¼Ǹindex ԭsection 
+	uint16 LayoutSerial = 0;
 
-				newSectionProxy->bSectionVisible = srcSection.bSectionVisible;
+	inline bool IsValid() const { return TransformSlot != INDEX_NONE; }
+};
 
-				Sections[sectionIndex] = newSectionProxy;
-			}
-		}
-#pragma endregion
 
-#pragma region CreateStructedBufferForSections
-		if (numSections > 0)
-		{
-			// structed buffer forsectiondeform transform
-			// ǰһcomponentsectionsһstructed buffer, trueʾҪCPU
-			TResourceArray<FMatrix>* resourceArray = new TResourceArray<FMatrix>(true);
+/**
+ * proxy ҪCPU , ֻgame thread Ƶsection , Կtask graph 
+ *  r.DeformMesh.AsyncProxyBuild. proxy 캯ֻΪÿsource mesh vertex factory, ֱmove ȥ
+ */
+struct FDeformMeshProxyBuildData
+{
+	/** һsection Ŀ, StaticMesh Material ֻΪkey, task в */
+	struct FSectionSnapshot
+	{
+		UStaticMesh* StaticMesh;
+		UMaterialInterface* Material;
+		// Ѿ r.DeformMesh.Deformers ˻Rigid
+		EDeformMeshDeformerKind DeformerKind;
+		FMatrix DeformTransform;
+		bool bVisible;
+		FDeformMeshDeformer Deformer;
+		FBox DeformedMeshBox;
+	};
+
+	// section index , ûStaticMesh section Ҳ
+	TArray<FSectionSnapshot> Snapshot;
+
+	// ƿʱcomponent SectionLayoutVersion, component һʱ
+	uint32 LayoutVersion = 0;
+
+	// ֮section transform ɼֱ, proxy ʱҪcomponent ¶ȡ
+	bool bTransformsStale = false;
+
+	// BuildDeformMeshProxyData , FDeformMeshSceneProxy еͬԱͬ
+	// ÿͬ(static mesh, deformer) һ, proxy ΪǴFDeformMeshSourceProxy
+	TArray<TPair<UStaticMesh*, EDeformMeshDeformerKind>> Sources;
+
+	// Groups еSource PreDeformedBase proxy д, GroupSources ÿgroup Sources еλ
+	TArray<FDeformMeshSectionGroup> Groups;
+	TArray<int32> GroupSources;
+
+	TArray<FDeformMeshSectionProxy> Sections;
+
+	// transform slot 
+	TArray<int32> SlotGroups;
+	TBitArray<> SlotVisible;
+	TArray<FMatrix> DeformTransforms;
+	TArray<FVector4> EncodedTransforms;
 
-			FRHIResourceCreateInfo createInfo;
-			resourceArray->Append(DeformTransforms);
-			createInfo.ResourceArray = resourceArray;
-			// õDebugNameΪܹRenderDocҵ
-			createInfo.DebugName = TEXT("DeformMesh_TransformsSB");
+	// Rigid slot Ҫsource mesh bounds, proxy д
+	TArray<FBoxSphereBounds> SlotLocalBounds;
 
-			DeformTransformsSB = RHICreateStructuredBuffer(sizeof(FMatrix),
-				numSections * sizeof(FMatrix), BUF_ShaderResource, createInfo);
-			bDeformTransformsDirty = false;
+	TArray<FVector4> DeformerParams;
+};
 
-			// Ϊstructed buffershader resource view
-			DeformTransformSRV = RHICreateShaderResourceView(DeformTransformsSB);
-		}
-#pragma endregion
+/**
+ * Կշ, transform slot, transform, deformer 
+ * UObject RHI, ̵߳
+ */
+static void BuildDeformMeshProxyData(FDeformMeshProxyBuildData& Data)
+{
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshProxyBuild);
+	LLM_SCOPE_DEFORM_MESH();
 
-	}
+	const int32 numSections = Data.Snapshot.Num();
+	Data.Sections.SetNum(numSections);
 
-	virtual ~FDeformMeshSceneProxy()
+#pragma region GroupSections
+	TMap<TPair<UStaticMesh*, EDeformMeshDeformerKind>, int32> sourceMap;
+	TMap<TPair<int32, UMaterialInterface*>, int32> groupMap;
+	for (int32 sectionIndex = 0; sectionIndex < numSections; sectionIndex++)
 	{
-		// ͷÿsection render resource
-		for (FDeformMeshSectionProxy* section : Sections)
+		const FDeformMeshProxyBuildData::FSectionSnapshot& section = Data.Snapshot[sectionIndex];
+		// ClearSection ֮Ŀslot proxy
+		if (section.StaticMesh == nullptr)
 		{
-			if (section != nullptr)
-			{
-				section->IndexBuffer.ReleaseResource();
-				section->IndexBuffer.ReleaseResource();
-				delete section;
-			}
+			continue;
 		}
 
-		// ͷstructed buffersrv
-		DeformTransformsSB.SafeRelease();
-		DeformTransformSRV.SafeRelease();
-
-	}
+		// ͬһstatic mesh deformer ֻһvertex factory (ÿLOD һ)
+		const TPair<UStaticMesh*, EDeformMeshDeformerKind> sourceKey(section.StaticMesh, section.DeformerKind);
+		const int32* sourceIndex = sourceMap.Find(sourceKey);
+		if (sourceIndex == nullptr)
+		{
+			sourceIndex = &sourceMap.Add(sourceKey, Data.Sources.Add(sourceKey));
+		}
 
-	void UpdateDeformTransformSB_RenderThread()
-	{
-		check(IsInActualRenderingThread());
-		if (bDeformTransformsDirty && DeformTransformsSB)
+		// NumSlots 
+		const TPair<int32, UMaterialInterface*> groupKey(*sourceIndex, section.Material);
+		int32* groupIndex = groupMap.Find(groupKey);
+		if (groupIndex == nullptr)
 		{
-			void* sbData = RHILockStructuredBuffer(DeformTransformsSB, 0,
-				DeformTransforms.Num() * sizeof(FMatrix), RLM_WriteOnly);
-			FMemory::Memcpy(sbData, DeformTransforms.GetData(),
-				DeformTransforms.Num() * sizeof(FMatrix));
-			RHIUnlockStructuredBuffer(DeformTransformsSB);
-			bDeformTransformsDirty = false;
+			FDeformMeshSectionGroup newGroup;
+			newGroup.Source = nullptr;
+			newGroup.Material = section.Material;
+			newGroup.FirstSlot = 0;
+			newGroup.NumSlots = 0;
+			Data.GroupSources.Add(*sourceIndex);
+			groupIndex = &groupMap.Add(groupKey, Data.Groups.Add(newGroup));
 		}
+
+		Data.Sections[sectionIndex].GroupIndex = *groupIndex;
+		Data.Groups[*groupIndex].NumSlots++;
 	}
+#pragma endregion
 
-	/**
-	 *  deformTransform structed buffer
-	 */
-	void UpdateDeformTransformSB_RenderThread(int32 SectionIndex, FMatrix DeformTransform)
+#pragma region AssignTransformSlots
+	// ͬһgroup section transform slot
+	int32 numSlots = 0;
+	for (FDeformMeshSectionGroup& group : Data.Groups)
 	{
-		check(IsInActualRenderingThread());
-		// Ҫstruted buffer
-		if (bDeformTransformsDirty && DeformTransformsSB)
-		{
-			void* bufferData = RHILockStructuredBuffer(
-				DeformTransformsSB,
-				0, // offset
-				DeformTransforms.Num() * sizeof(FMatrix), // buffer size
-				RLM_WriteOnly
-			);
-			FMemory::Memcpy(bufferData, DeformTransforms.GetData(),
-				DeformTransforms.Num() * sizeof(FMatrix));
-			RHIUnlockStructuredBuffer(DeformTransformsSB);
-			bDeformTransformsDirty = false;
-		}
+		group.FirstSlot = numSlots;
+		numSlots += group.NumSlots;
 	}
 
-	/**
-	 *  Ӧsection id transform ֻҪsection array ֵעmark dirty
-	 */
-	void UpateDeformTransofm_RenderThread(int32 SectionIndex, FMatrix DeformTransform)
+	Data.SlotGroups.SetNumUninitialized(numSlots);
+	Data.SlotVisible.Init(true, numSlots);
+	Data.DeformTransforms.SetNumUninitialized(numSlots);
+	Data.SlotLocalBounds.SetNumZeroed(numSlots);
+	TArray<const FDeformMeshDeformer*> slotDeformers;
+	slotDeformers.SetNumUninitialized(numSlots);
+
+	// section index ˳ÿgroup һslot, ͬһgroup ڱsection ˳
+	TArray<int32, TInlineAllocator<16>> nextGroupSlot;
+	nextGroupSlot.SetNumUninitialized(Data.Groups.Num());
+	for (int32 groupIndex = 0; groupIndex < Data.Groups.Num(); groupIndex++)
 	{
-		check(IsInRenderingThread());
-
-		if (SectionIndex < Sections.Num() &&
-			Sections[SectionIndex] != nullptr)
-		{
-			DeformTransforms[SectionIndex] = DeformTransform;
-			bDeformTransformsDirty = true;
-		}
+		nextGroupSlot[groupIndex] = Data.Groups[groupIndex].FirstSlot;
 	}
-
-	void SetSectionVisibility_RenderThread(int32 SectionIndex, bool bNewVisibility)
+	for (int32 sectionIndex = 0; sectionIndex < numSections; sectionIndex++)
 	{
-		check(IsInActualRenderingThread());
-
-		if (SectionIndex < Sections.Num() &&
-			Sections[SectionIndex] != nullptr)
+		FDeformMeshSectionProxy& sectionProxy = Data.Sections[sectionIndex];
+		if (sectionProxy.GroupIndex == INDEX_NONE)
 		{
-			Sections[SectionIndex]->bSectionVisible = bNewVisibility;
+			continue;
+		}
 
-			//#Unkown ﲻҪmark dirty ?????????
-			//bDeformTransformsDirty = true;
+		const FDeformMeshProxyBuildData::FSectionSnapshot& section = Data.Snapshot[sectionIndex];
+		const int32 slot = nextGroupSlot[sectionProxy.GroupIndex]++;
+		sectionProxy.TransformSlot = slot;
+		Data.SlotGroups[slot] = sectionProxy.GroupIndex;
+		Data.SlotVisible[slot] = section.bVisible;
+		Data.DeformTransforms[slot] = section.DeformTransform;
+		slotDeformers[slot] = &section.Deformer;
+		if (section.DeformerKind != EDeformMeshDeformerKind::Rigid && section.DeformedMeshBox.IsValid)
+		{
+			Data.SlotLocalBounds[slot] = FBoxSphereBounds(section.DeformedMeshBox);
 		}
 	}
 
-	/**
-	 * viewsvisiblityMap,ҪMeshBatch
-	 */
-	void GetDynamicMeshElements(const TArray<const FSceneView*>& Views,
-		const FSceneViewFamily& ViewFamily, uint32 VisibilityMap,
-		class FMeshElementCollector& Collector) const override
+	const EDeformTransformEncoding encoding = GetDeformTransformEncoding();
+	const int32 transformStride = GetDeformTransformStride(encoding);
+	Data.EncodedTransforms.SetNumUninitialized(numSlots * transformStride);
+	for (int32 slot = 0; slot < numSlots; slot++)
 	{
-		const bool bUseWireframe = AllowDebugViewmodes() &&
-			ViewFamily.EngineShowFlags.Wireframe;
+		EncodeDeformTransform(encoding, Data.DeformTransforms[slot], &Data.EncodedTransforms[slot * transformStride]);
+	}
+#pragma endregion
 
-		FColoredMaterialRenderProxy* wireframeMaterialInstance = nullptr;
-		if (bUseWireframe)
+#pragma region PackDeformerParams
+	// ÿRigid group Ĳslot ˳
+	for (int32 groupIndex = 0; groupIndex < Data.Groups.Num(); groupIndex++)
+	{
+		FDeformMeshSectionGroup& group = Data.Groups[groupIndex];
+		const EDeformMeshDeformerKind deformerKind = Data.Sources[Data.GroupSources[groupIndex]].Value;
+		const int32 stride = GetDeformMeshDeformerParamStride(deformerKind);
+		const int32 paramBase = Data.DeformerParams.Num() - group.FirstSlot * stride;
+		for (FDeformMeshBatchUserData& userData : group.BatchUserData)
 		{
-			wireframeMaterialInstance = new FColoredMaterialRenderProxy(
-				GEngine->WireframeMaterial ? GEngine->WireframeMaterial->GetRenderProxy() : nullptr,
-				FLinearColor(0.f, 0.5f, 1.f)
-			);
-
-			// proxyڴչcollector
-			Collector.RegisterOneFrameMaterialProxy(wireframeMaterialInstance);
+			userData.PreDeformedBase = 0;
+			userData.DeformerParamBase = paramBase;
 		}
 
-		for (const FDeformMeshSectionProxy* sectionProxy : Sections)
+		if (stride > 0)
 		{
-			if (sectionProxy && sectionProxy->bSectionVisible)
+			for (int32 slot = group.FirstSlot; slot < group.FirstSlot + group.NumSlots; slot++)
 			{
-				FMaterialRenderProxy* materialProxy = bUseWireframe ?
-					wireframeMaterialInstance : sectionProxy->SectionMaterial->GetRenderProxy();
-
-				// foreach view
-				for (int32 viewIndex = 0; viewIndex < Views.Num(); viewIndex++)
-				{
-					// meshԵǰviewǷɼ
-					bool bVisibleToView = VisibilityMap & (1 << viewIndex);
-					if (bVisibleToView)
-					{
-						const FSceneView* sceneView = Views[viewIndex];
-
-#pragma region ContructMeshBatch
-						FMeshBatch& meshBatch = Collector.AllocateMesh();
-						FMeshBatchElement& batchElement = meshBatch.Elements[0];
-#pragma endregion
-						batchElement.IndexBuffer = &sectionProxy->IndexBuffer;
-						meshBatch.bWireframe = bUseWireframe;
-						meshBatch.VertexFactory = &sectionProxy->VertexFactory;
-						meshBatch.MaterialRenderProxy = materialProxy;
-
-						// LocalVertexFactory һuniform buffer 
-						// localToWorld previousLocalToWorldȵ, 󲿷ֶhelper function
-						bool bHasPrecomputedVolumetricLightmap;
-						FMatrix prevousLocalToWorld;
-						int32 singleCaptureIndex;
-						bool bOutputVelocity;
-						GetScene().GetPrimitiveUniformShaderParameters_RenderThread(
-							GetPrimitiveSceneInfo(),
-							bHasPrecomputedVolumetricLightmap,
-							prevousLocalToWorld,
-							singleCaptureIndex,
-							bOutputVelocity
-						);
-						FDynamicPrimitiveUniformBuffer& dynamicUniformBuffer =
-							Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
-						// һʱprimitive uniform buffer, õbatchElement
-						dynamicUniformBuffer.Set(GetLocalToWorld(),
-							prevousLocalToWorld,
-							GetBounds(), GetLocalBounds(),
-							true, bHasPrecomputedVolumetricLightmap,
-							DrawsVelocity(), bOutputVelocity);
-						batchElement.PrimitiveUniformBufferResource = &dynamicUniformBuffer.UniformBuffer;
-						batchElement.PrimitiveIdMode = PrimID_DynamicPrimitiveShaderData;
-
-						// additional data
-						batchElement.FirstIndex = 0;
-						batchElement.NumPrimitives = sectionProxy->IndexBuffer.GetNumIndices() / 3;
-						batchElement.MinVertexIndex = 0;
-						batchElement.MaxVertexIndex = sectionProxy->MaxVertexIndex;
-
-						meshBatch.ReverseCulling = IsLocalToWorldDeterminantNegative();
-						meshBatch.Type = PT_TriangleList;
-						meshBatch.DepthPriorityGroup = SDPG_World;
-						meshBatch.bCanApplyViewModeOverrides = false;
-
-						//add batch to collector
-						Collector.AddMesh(viewIndex, meshBatch);
-					}
-				}
+				FDeformMeshDeformer deformer = *slotDeformers[slot];
+				deformer.Kind = deformerKind;
+				PackDeformMeshDeformerParams(deformer, Data.DeformerParams);
 			}
 		}
 	}
+#pragma endregion
+}
 
-	FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
-	{
-		FPrimitiveViewRelevance res;
-		res.bDrawRelevance = IsShown(View);
-		res.bShadowRelevance = IsShadowCast(View);
-		res.bDynamicRelevance = true;
-		res.bRenderInMainPass = ShouldRenderInMainPass();
-		res.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
-		res.bRenderCustomDepth = ShouldRenderCustomDepth();
-		res.bTranslucentSelfShadow = bCastVolumetricTranslucentShadow;
-		// cachecan be occluded
-		MaterialRelevance.SetPrimitiveViewRelevance(res);
-		res.bVelocityRelevance = IsMovable() && res.bOpaque && res.bRenderInMainPass;
-		return res;
-	}
-
-	bool CanBeOccluded() const override
-	{
-		return !MaterialRelevance.bDisableDepthTest;
-	}
-
+enum class EDeformMeshUpdateType : uint8
+{
+	// UpdateSectionTransform
+	Transform,
+	// SetMeshSectionVisible
+	Visibility,
+	// FinishDeformUpdate
+	Upload,
+};
 
-	uint32 GetAllocatedSize(void) const
-	{
-		return (FPrimitiveSceneProxy::GetAllocatedSize());
-	}
+/**
+ * game thread (worker thread) proxy һθ, ÿεһrender command, 64 bytes
+ */
+struct FDeformMeshUpdateRecord
+{
+	FDeformMeshSceneProxy* Proxy;
+	int32 SectionIndex;
+	EDeformMeshUpdateType Type;
+	bool bVisible;
 
-	inline FShaderResourceViewRHIRef& GetDeformTransformsSRV() { return DeformTransformSRV; }
+	// push ʱcomponent InPlaceSectionSerial, section index ָserial section layout
+	uint16 LayoutSerial;
 
-	virtual uint32 GetMemoryFootprint(void) const override
-	{
-		return (sizeof(*this) + GetAllocatedSize());
-	}
+	// תùdeform transform ǰ, (0, 0, 0, 1)
+	FVector4 TransformRows[3];
+};
 
+static void ApplyDeformMeshUpdateRecord_RenderThread(const FDeformMeshUpdateRecord& Record);
 
-private:
-	TArray<FDeformMeshSectionProxy*> Sections;
+// , ɾѹsection proxy, һdrain кproxy һϴ, ֻrender thread ʹ
+static TArray<FDeformMeshSceneProxy*> GDeformMeshSlotsChangedProxies;
 
+/**
+ * live proxy һsection Ҫ, game thread ׼
+ * CreateSection ֮section Rigid ҿɼ
+ */
+struct FDeformMeshAddSectionData
+{
+	int32 SectionIndex;
 
-	FMaterialRelevance MaterialRelevance;
+	// ֻΪsource key
+	UStaticMesh* StaticMesh;
+	FStaticMeshRenderData* RenderData;
 
-	//  ÿsection вͬdeform transform
-	TArray<FMatrix> DeformTransforms;
+	UMaterialInterface* Material;
 
-	// deform transformϢ Ϊshader resource  shader
-	FStructuredBufferRHIRef DeformTransformsSB;
+	FMatrix DeformTransform;
 
-	// structed buffershader resource view, 󶨵vertex factory 
-	FShaderResourceViewRHIRef DeformTransformSRV;
+	// ²֮component material relevance
+	FMaterialRelevance MaterialRelevance;
 
-	// structed buffersǷҪµdirty flag
-	bool bDeformTransformsDirty;
+#if WITH_EDITOR
+	TArray<UMaterialInterface*> UsedMaterials;
+#endif
 };
 
-//#Unkown ɶ Mannual fetch
+class FDeformMeshSceneProxy final : public FPrimitiveSceneProxy, public IDeformMeshTransformUploadListener
+{
+public:
+	SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+	/**
+	 * BuildData ѾBuildDeformMeshProxyData , ᱻmove 
+	 */
+	FDeformMeshSceneProxy(UDeformMeshComponent* deformCom, FDeformMeshProxyBuildData& BuildData)
+		: FPrimitiveSceneProxy(deformCom)
+		, Sections(MoveTemp(BuildData.Sections))
+		, Groups(MoveTemp(BuildData.Groups))
+		, SlotVisible(MoveTemp(BuildData.SlotVisible))
+		, SlotLocalBounds(MoveTemp(BuildData.SlotLocalBounds))
+		, MaterialRelevance(deformCom->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+		, DeformTransforms(MoveTemp(BuildData.DeformTransforms))
+		, EncodedTransforms(MoveTemp(BuildData.EncodedTransforms))
+		, bUseStaticDrawPath(CVarDeformMeshCacheStaticDraw.GetValueOnAnyThread() != 0 &&
+			!ExceedsStaticDrawMaxSections(BuildData.DeformTransforms.Num()))
+		, NumCachedMeshBatches(0)
+		, TransformBufferDepth(FMath::Clamp(CVarDeformMeshTransformBufferDepth.GetValueOnAnyThread(), 1, 4))
+		, LODBias(deformCom->LODBias)
+		, TransformEncoding(GetDeformTransformEncoding())
+		, TransformStride(GetDeformTransformStride(TransformEncoding))
+		, SlotCapacity(BuildData.DeformTransforms.Num())
+		, NumLiveSections(BuildData.DeformTransforms.Num())
+		, AppliedLayoutSerial(deformCom->InPlaceSectionSerial)
+		, CurrentSlice(0)
+		, PreviousSlice(0)
+		, LastSliceAdvanceFrame(0)
+		, bUsePreDeform(IsDeformMeshPreDeformEnabled(GetScene().GetShaderPlatform()))
+		, NumPreDeformedVertices(0)
+		, DeformerParams(MoveTemp(BuildData.DeformerParams))
+	{
+		const int32 numSlots = DeformTransforms.Num();
+
+#pragma region CreateSourceProxies
+		// Ҫstatic mesh render data, ֻgame thread 
+		TArray<FDeformMeshSourceProxy*, TInlineAllocator<8>> sources;
+		for (const TPair<UStaticMesh*, EDeformMeshDeformerKind>& sourceKey : BuildData.Sources)
+		{
+			sources.Add(CreateSourceProxy(sourceKey.Key, sourceKey.Key->RenderData.Get(), sourceKey.Value));
+		}
+
+		for (int32 groupIndex = 0; groupIndex < Groups.Num(); groupIndex++)
+		{
+			FDeformMeshSectionGroup& group = Groups[groupIndex];
+			group.Source = sources[BuildData.GroupSources[groupIndex]];
+			// ǰÿsection Ḵһindex buffer
+			IndexBytesSaved += group.NumSlots * group.Source->GetSharedIndexBytes();
+		}
+
+		SlotSources.SetNumUninitialized(numSlots);
+		for (int32 slot = 0; slot < numSlots; slot++)
+		{
+			FDeformMeshSourceProxy* source = Groups[BuildData.SlotGroups[slot]].Source;
+			SlotSources[slot] = source;
+			source->NumLiveSlots++;
+			if (source->DeformerKind == EDeformMeshDeformerKind::Rigid || SlotLocalBounds[slot].SphereRadius == 0.f)
+			{
+				SlotLocalBounds[slot] = source->Bounds;
+			}
+		}
+		// local to world OnTransformChanged вЧ, ʱټ
+		SlotWorldBounds.SetNumZeroed(numSlots);
+
+		SlotSectionIndices.SetNumUninitialized(numSlots);
+		for (int32 sectionIndex = 0; sectionIndex < Sections.Num(); sectionIndex++)
+		{
+			if (Sections[sectionIndex].IsValid())
+			{
+				SlotSectionIndices[Sections[sectionIndex].TransformSlot] = sectionIndex;
+				Sections[sectionIndex].LayoutSerial = AppliedLayoutSerial;
+			}
+		}
+#pragma endregion
+
+#pragma region RefreshStaleTransforms
+		// ̨build ڼsection ֱ¹, 鲻, ֻ¶ȡtransform Ϳɼ
+		if (BuildData.bTransformsStale)
+		{
+			for (int32 sectionIndex = 0; sectionIndex < Sections.Num(); sectionIndex++)
+			{
+				const FDeformMeshSectionProxy& sectionProxy = Sections[sectionIndex];
+				if (sectionProxy.IsValid())
+				{
+					const FDeformMeshSection& srcSection = deformCom->DeformMeshSections[sectionIndex];
+					DeformTransforms[sectionProxy.TransformSlot] = srcSection.DeformTransform;
+					SlotVisible[sectionProxy.TransformSlot] = srcSection.bSectionVisible;
+				}
+			}
+			for (int32 slot = 0; slot < numSlots; slot++)
+			{
+				EncodeDeformTransform(TransformEncoding, DeformTransforms[slot], &EncodedTransforms[slot * TransformStride]);
+			}
+		}
+
+		SliceDirtyTransforms.SetNum(TransformBufferDepth);
+		for (TBitArray<>& sliceDirty : SliceDirtyTransforms)
+		{
+			sliceDirty.Init(false, numSlots);
+		}
+		PendingPreDeformSlots.Init(false, numSlots);
+#pragma endregion
+
+#pragma region AssignPreDeformedPositions
+		// ÿgroup ÿLOD NumSlots ݶ
+		for (FDeformMeshSectionGroup& group : Groups)
+		{
+			for (int32 lodIndex = 0; lodIndex < MAX_STATIC_MESH_LODS; lodIndex++)
+			{
+				group.BatchUserData[lodIndex].PreDeformedBase = 0;
+				if (bUsePreDeform && lodIndex >= group.Source->MinLOD && lodIndex < group.Source->LODs.Num())
+				{
+					const int32 numVertices = group.Source->LODs[lodIndex].MaxVertexIndex + 1;
+					group.BatchUserData[lodIndex].PreDeformedBase = NumPreDeformedVertices - group.FirstSlot * numVertices;
+					NumPreDeformedVertices += group.NumSlots * numVertices;
+				}
+			}
+		}
+#pragma endregion
+
+		INC_MEMORY_STAT_BY(STAT_DeformMeshIndexBytesSaved, IndexBytesSaved);
+		INC_DWORD_STAT_BY(STAT_DeformMeshSections, numSlots);
+
+		// 4.26 AlwaysHasVelocity virtual, ֻȡflag, cached velocity command Ҳÿ֡²ѯ
+		// flag ֲ, Ƿvelocity ÿ֡GetViewRelevance о
+		bAlwaysHasVelocity = TransformBufferDepth > 1;
+
+		bDeformTransformsDirty = false;
+		bUploadListenerQueued = false;
+		bUploadRequested = false;
+
+		// ֻӻɾsection ֮¼, DirtyRanges Բ
+		UpdateCPUAllocatedSize();
+	}
+
+	void UpdateCPUAllocatedSize()
+	{
+		DEC_MEMORY_STAT_BY(STAT_DeformMeshProxyCPUBytes, CPUAllocatedSize);
+		CPUAllocatedSize = GetAllocatedSize();
+		INC_MEMORY_STAT_BY(STAT_DeformMeshProxyCPUBytes, CPUAllocatedSize);
+	}
+
+	/**
+	 * static mesh ÿLOD vertex factory, index buffer ֱʹstatic mesh 
+	 * ʱgame thread , live proxy section ʱrender thread , RenderData game thread ȡ
+	 */
+	FDeformMeshSourceProxy* CreateSourceProxy(UStaticMesh* StaticMesh, FStaticMeshRenderData* renderData,
+		EDeformMeshDeformerKind DeformerKind)
+	{
+		FDeformMeshSourceProxy* newSource = new FDeformMeshSourceProxy();
+		newSource->Bounds = renderData->Bounds;
+		newSource->DeformerKind = DeformerKind;
+		newSource->StaticMesh = StaticMesh;
+		newSource->MinLOD = FMath::Clamp<int32>(renderData->CurrentFirstLODIdx, 0, renderData->LODResources.Num() - 1);
+
+		for (int32 lodIndex = 0; lodIndex < renderData->LODResources.Num(); lodIndex++)
+		{
+			FStaticMeshLODResources& LODResource = renderData->LODResources[lodIndex];
+
+			FDeformMeshSourceLOD* newLOD = new FDeformMeshSourceLOD();
+			newSource->LODs.Add(newLOD);
+			newLOD->ScreenSize = renderData->ScreenSize[lodIndex].GetValue();
+
+			// ûstream in LOD ᱻѡ, Ҫrender resource
+			if (lodIndex < newSource->MinLOD)
+			{
+				continue;
+			}
+
+			newLOD->VertexFactory.Reset(CreateDeformMeshVertexFactory(DeformerKind, GetScene().GetFeatureLevel()));
+			FDeformMeshVertexFactory* vertexFactory = newLOD->VertexFactory.Get();
+
+			// static meshеֵʼvertex factory
+			InitVertexFactoryData(vertexFactory, &(LODResource.VertexBuffers));
+
+			vertexFactory->SetSceneProxy(this);
+
+			// static mesh index buffer Ѿʼ, ֱ, ԭ16/32 bit ʽ
+			newLOD->IndexBuffer = &LODResource.IndexBuffer;
+			newLOD->PositionBuffer = &LODResource.VertexBuffers.PositionVertexBuffer;
+
+			// section maxVertexIndex
+			newLOD->MaxVertexIndex =
+				LODResource.VertexBuffers.PositionVertexBuffer.GetNumVertices() - 1;
+			newLOD->NumPrimitives = LODResource.IndexBuffer.GetNumIndices() / 3;
+		}
+
+		SourceMeshes.Add(newSource);
+		return newSource;
+	}
+
+	/**
+	 * render thread structed buffer  uniform buffer, DrawStaticElements ֮ǰ
+	 */
+	void CreateRenderThreadResources() override
+	{
+		LLM_SCOPE_DEFORM_MESH();
+		const int32 numSections = DeformTransforms.Num();
+
+#pragma region AllocateTransformSlots
+		if (numSections > 0)
+		{
+			// component GDeformMeshTransformPool, proxy ռһslot, ֳTransformBufferDepth slice,
+			// ÿ֡дһslice, һslice һ֡transform
+			TransformAllocation = GDeformMeshTransformPool.Allocate(TransformBufferDepth * SlotCapacity);
+			for (int32 slice = 0; slice < TransformBufferDepth; slice++)
+			{
+				GDeformMeshTransformPool.Write(TransformAllocation, slice * SlotCapacity, EncodedTransforms.GetData(), numSections);
+			}
+		}
+#pragma endregion
+
+		CreateDeformerParamsBuffer_RenderThread();
+
+		DeformMeshUniformBuffer = TUniformBufferRef<FDeformMeshVFUniformParameters>::CreateUniformBufferImmediate(
+			GetVFUniformParameters(), UniformBuffer_MultiFrame);
+
+#pragma region CreatePreDeformedPositions
+		if (NumPreDeformedVertices > 0)
+		{
+			const uint32 numBytes = NumPreDeformedVertices * 3 * sizeof(float);
+
+			FRHIResourceCreateInfo createInfo;
+			createInfo.DebugName = TEXT("DeformMesh_PreDeformedPositions");
+			PreDeformedPositionsVB = RHICreateVertexBuffer(numBytes, BUF_Static | BUF_UnorderedAccess | BUF_ShaderResource, createInfo);
+			PreDeformedPositionsSRV = RHICreateShaderResourceView(PreDeformedPositionsVB, sizeof(float), PF_R32_FLOAT);
+			PreDeformedPositionsUAV = RHICreateUnorderedAccessView(PreDeformedPositionsVB, PF_R32_FLOAT);
+			INC_MEMORY_STAT_BY(STAT_DeformMeshPreDeformedBytes, numBytes);
+
+			// slot ûdeform , transform Ҫpool Flush ֮GPU 
+			const FDeformTransformRange allSlots = { 0, numSections };
+			QueuePreDeform_RenderThread(MakeArrayView(&allSlots, 1));
+		}
+#pragma endregion
+
+		INC_MEMORY_STAT_BY(STAT_DeformMeshProxyGPUBytes, GetGPUAllocatedSize());
+
+		// 4.26 PreRenderViewFamily ֮primitive, ܵscene view extension, uniform buffer ѾָЩslot
+		GDeformMeshTransformPool.Flush(FRHICommandListExecutor::GetImmediateCommandList());
+	}
+
+	/**
+	 * ֻڴproxy ɾRigid section (slot ƶ) ʱ, ÿ´buffer
+	 */
+	void CreateDeformerParamsBuffer_RenderThread()
+	{
+		bDeformerParamsDirty = false;
+		if (DeformerParams.Num() == 0)
+		{
+			return;
+		}
+
+		TResourceArray<FVector4> resourceArray(true);
+		resourceArray.Append(DeformerParams);
+
+		FRHIResourceCreateInfo createInfo(&resourceArray);
+		createInfo.DebugName = TEXT("DeformMesh_DeformerParamsSB");
+
+		DeformerParamsSB = RHICreateStructuredBuffer(sizeof(FVector4),
+			DeformerParams.Num() * sizeof(FVector4), BUF_Static | BUF_ShaderResource, createInfo);
+		DeformerParamsSRV = RHICreateShaderResourceView(DeformerParamsSB);
+	}
+
+	/**
+	 * SlotRanges еslot pre deform compute shader, ȡDMTransforms ĵǰslice
+	 * ÿgroup SlotRanges صĲ, ÿLOD һdispatch
+	 */
+	void DispatchPreDeform_RenderThread(FRHICommandList& RHICmdList, TArrayView<const FDeformTransformRange> SlotRanges)
+	{
+		if (!PreDeformedPositionsUAV)
+		{
+			return;
+		}
+
+		TArray<FDeformMeshPreDeformDispatch, TInlineAllocator<16>> dispatches;
+		for (const FDeformMeshSectionGroup& group : Groups)
+		{
+			// source Ѿͷŵgroup ֻʣslot
+			if (group.Source == nullptr)
+			{
+				continue;
+			}
+
+			const int32 groupEnd = group.FirstSlot + group.NumSlots;
+			for (const FDeformTransformRange& range : SlotRanges)
+			{
+				const int32 first = FMath::Max(range.First, group.FirstSlot);
+				const int32 end = FMath::Min(range.First + range.Num, groupEnd);
+				if (first >= end)
+				{
+					continue;
+				}
+
+				const FDeformMeshSourceProxy* source = group.Source;
+				for (int32 lodIndex = source->MinLOD; lodIndex < source->LODs.Num(); lodIndex++)
+				{
+					const FDeformMeshSourceLOD& sourceLOD = source->LODs[lodIndex];
+					FRHIShaderResourceView* sourcePositions = sourceLOD.PositionBuffer->GetSRV();
+					// position buffer ûSRV ʱ (֧manual vertex fetch ƽ̨) ûpre deform
+					if (!ensureMsgf(sourcePositions, TEXT("DeformMesh: source position buffer has no SRV, r.DeformMesh.PreDeform needs one")))
+					{
+						continue;
+					}
+
+					FDeformMeshPreDeformDispatch& dispatch = dispatches.AddDefaulted_GetRef();
+					dispatch.SourcePositions = sourcePositions;
+					dispatch.NumVertices = sourceLOD.MaxVertexIndex + 1;
+					dispatch.FirstSlot = first;
+					dispatch.NumSlots = end - first;
+					dispatch.OutputBase = group.BatchUserData[lodIndex].PreDeformedBase;
+					dispatch.DeformerKind = source->DeformerKind;
+					dispatch.DeformerParamBase = group.BatchUserData[lodIndex].DeformerParamBase;
+				}
+			}
+		}
+
+		DispatchDeformMeshPreDeform(RHICmdList, GetScene().GetFeatureLevel(), GDeformMeshTransformPool.GetSRV(TransformAllocation),
+			TransformAllocation.Offset + CurrentSlice * SlotCapacity, DeformerParamsSRV, GetLocalToWorld(), PreDeformedPositionsUAV, dispatches);
+		INC_DWORD_STAT_BY(STAT_DeformMeshPreDeformDispatches, dispatches.Num());
+	}
+
+	/**
+	 * SlotRanges еslot һGDeformMeshTransformPool Flush ֮pre deform, ͬһ֡θֻdispatch һ
+	 */
+	void QueuePreDeform_RenderThread(TArrayView<const FDeformTransformRange> SlotRanges)
+	{
+		if (!PreDeformedPositionsUAV)
+		{
+			return;
+		}
+
+		for (const FDeformTransformRange& range : SlotRanges)
+		{
+			PendingPreDeformSlots.SetRange(range.First, range.Num, true);
+		}
+		QueueUploadListener_RenderThread();
+	}
+
+	void QueueUploadListener_RenderThread()
+	{
+		if (!bUploadListenerQueued)
+		{
+			GDeformMeshTransformPool.AddUploadListener(this);
+			bUploadListenerQueued = true;
+		}
+	}
+
+	//~ IDeformMeshTransformUploadListener
+	void OnTransformsUploaded_RenderThread(FRHICommandListImmediate& RHICmdList) override
+	{
+		bUploadListenerQueued = false;
+
+		// buffer ֻһ, Ҫϴһϲclean slot
+		BuildDirtyRanges(PendingPreDeformSlots, 0, DirtyRanges);
+		PendingPreDeformSlots.Init(false, PendingPreDeformSlots.Num());
+		if (DirtyRanges.Num() > 0)
+		{
+			DispatchPreDeform_RenderThread(RHICmdList, DirtyRanges);
+		}
+
+		SettlePreviousSlice_RenderThread();
+
+		if (RetiredSources.Num() > 0)
+		{
+			// һ֡Ⱦ֮ǰcached mesh draw command Ѿؽ, ֮֡ͷvertex factory
+			if (GFrameNumberRenderThread > RetiredSourcesFrame)
+			{
+				ReleaseRetiredSources_RenderThread();
+			}
+			else
+			{
+				QueueUploadListener_RenderThread();
+			}
+		}
+	}
+
+	virtual ~FDeformMeshSceneProxy()
+	{
+		DEC_MEMORY_STAT_BY(STAT_DeformMeshProxyGPUBytes, GetGPUAllocatedSize());
+		DEC_MEMORY_STAT_BY(STAT_DeformMeshProxyCPUBytes, CPUAllocatedSize);
+
+		if (bUploadListenerQueued)
+		{
+			GDeformMeshTransformPool.RemoveUploadListener(this);
+		}
+		if (bSlotsChangedQueued)
+		{
+			GDeformMeshSlotsChangedProxies.RemoveSwap(this);
+		}
+		// slot pool, page proxy SRV Ӱ
+		GDeformMeshTransformPool.Free(TransformAllocation);
+
+		ReleaseRetiredSources_RenderThread();
+
+		// ͷÿsource mesh render resource, index buffer static mesh, ͷ
+		for (FDeformMeshSourceProxy* source : SourceMeshes)
+		{
+			for (FDeformMeshSourceLOD& sourceLOD : source->LODs)
+			{
+				if (sourceLOD.VertexFactory)
+				{
+					sourceLOD.VertexFactory->ReleaseResource();
+				}
+			}
+			delete source;
+		}
+
+		// ͷstructed buffersrv
+		DeformMeshUniformBuffer.SafeRelease();
+		DeformerParamsSB.SafeRelease();
+		DeformerParamsSRV.SafeRelease();
+
+		if (PreDeformedPositionsVB)
+		{
+			DEC_MEMORY_STAT_BY(STAT_DeformMeshPreDeformedBytes, PreDeformedPositionsVB->GetSize());
+		}
+		PreDeformedPositionsUAV.SafeRelease();
+		PreDeformedPositionsSRV.SafeRelease();
+		PreDeformedPositionsVB.SafeRelease();
+
+		DEC_DWORD_STAT_BY(STAT_DeformMeshCachedBatches, NumCachedMeshBatches);
+		DEC_MEMORY_STAT_BY(STAT_DeformMeshIndexBytesSaved, IndexBytesSaved);
+		DEC_DWORD_STAT_BY(STAT_DeformMeshSections, NumLiveSections);
+		DEC_DWORD_STAT_BY(STAT_DeformMeshEmptySlots, DeformTransforms.Num() - NumLiveSections);
+	}
+
+	/**
+	 * dirty section дGDeformMeshTransformPool, ϴFlush кproxy һϲ
+	 * ÿ֡һθʱлһslice, һslice һ֡transform
+	 * slice Ϊ˱ܿGPU ڶڴ, pool ϴʱlock page, FDeformMeshTransformPool
+	 */
+	void UpdateDeformTransformSB_RenderThread()
+	{
+		check(IsInActualRenderingThread());
+		bUploadRequested = false;
+		if (bDeformTransformsDirty && TransformAllocation.IsValid())
+		{
+			SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshUploadTransforms);
+
+			const int32 numSections = DeformTransforms.Num();
+
+			if (TransformBufferDepth > 1 && LastSliceAdvanceFrame != GFrameNumberRenderThread)
+			{
+				// ɵslice һ֮֡ǰtransform, velocity 
+				PreviousSlice = CurrentSlice;
+				CurrentSlice = (CurrentSlice + 1) % TransformBufferDepth;
+				LastSliceAdvanceFrame = GFrameNumberRenderThread;
+				// ֮֡ûиʱOnTransformsUploaded_RenderThread һ֡slice
+				QueueUploadListener_RenderThread();
+			}
+
+			// slice ϴд֮б仯section dirty bits 
+			TBitArray<>& sliceDirty = SliceDirtyTransforms[CurrentSlice];
+			BuildDirtyRanges(sliceDirty, 0, DirtyRanges);
+
+			const int32 sliceOffset = CurrentSlice * SlotCapacity;
+			for (const FDeformTransformRange& range : DirtyRanges)
+			{
+				GDeformMeshTransformPool.Write(TransformAllocation, sliceOffset + range.First,
+					&EncodedTransforms[range.First * TransformStride], range.Num);
+			}
+
+			// дб仯section, buffer ֻһ, ͬdeform ͹
+			QueuePreDeform_RenderThread(DirtyRanges);
+
+			sliceDirty.Init(false, numSections);
+			bDeformTransformsDirty = false;
+
+			// vertex factory ȡµslice
+			DeformMeshUniformBuffer.UpdateUniformBufferImmediate(GetVFUniformParameters());
+
+			// section ƶܱ֮øɢ
+			UpdateDrawPath_RenderThread();
+		}
+	}
+
+	static bool ExceedsStaticDrawMaxSections(int32 NumSections)
+	{
+		const int32 maxSections = CVarDeformMeshCacheStaticDrawMaxSections.GetValueOnAnyThread();
+		return maxSections > 0 && NumSections > maxSections;
+	}
+
+	/**
+	 * cached path ֻcomponent ޳ѡLOD, section Ҿһʱʡÿ֡mesh batch Ŀ,
+	 * section ߷ɢʱper section ޳LOD ʡµĸ, dynamic path
+	 * section world bounds box 뾶section 뾶֮Ⱥɢ̶, 20% Ļز
+	 */
+	bool ShouldUseStaticDrawPath() const
+	{
+		if (CVarDeformMeshCacheStaticDraw.GetValueOnRenderThread() == 0 || ExceedsStaticDrawMaxSections(NumLiveSections))
+		{
+			return false;
+		}
+
+		const float maxSpread = CVarDeformMeshCacheStaticDrawMaxSpread.GetValueOnRenderThread();
+		if (maxSpread <= 0.f)
+		{
+			return true;
+		}
+
+		FBox unionBox(ForceInit);
+		float maxSectionRadius = 0.f;
+		for (int32 slot = 0; slot < SlotWorldBounds.Num(); slot++)
+		{
+			if (SlotSources[slot] != nullptr)
+			{
+				unionBox += SlotWorldBounds[slot].GetBox();
+				maxSectionRadius = FMath::Max(maxSectionRadius, SlotWorldBounds[slot].SphereRadius);
+			}
+		}
+
+		// world bounds û
+		if (maxSectionRadius <= 0.f)
+		{
+			return bUseStaticDrawPath;
+		}
+
+		const float spread = unionBox.GetExtent().Size() / maxSectionRadius;
+		return spread <= (bUseStaticDrawPath ? maxSpread : maxSpread * 0.8f);
+	}
+
+	/**
+	 * path ʱcache mesh draw command, еdynamic path ʱDrawStaticElements ʲôҲύ
+	 */
+	void UpdateDrawPath_RenderThread()
+	{
+		const bool bNewUseStaticDrawPath = ShouldUseStaticDrawPath();
+		if (bNewUseStaticDrawPath != bUseStaticDrawPath)
+		{
+			bUseStaticDrawPath = bNewUseStaticDrawPath;
+			GetScene().UpdateCachedRenderStates(this);
+		}
+	}
+
+	/**
+	 * ǰһ֡slice λ, һ֡ûлslice ʱǵǰslice
+	 */
+	FDeformMeshVFUniformParameters GetVFUniformParameters() const
+	{
+		FDeformMeshVFUniformParameters uniformParameters;
+		uniformParameters.TransformBaseIndex = TransformAllocation.Offset + CurrentSlice * SlotCapacity;
+		uniformParameters.PrevTransformBaseIndex = TransformAllocation.Offset + PreviousSlice * SlotCapacity;
+		return uniformParameters;
+	}
+
+	/**
+	 * һ֡section transform , ʹcomponent ûƶҲҪvelocity
+	 * uniform buffer ͬһ״̬, Ƚview FrameNumber, scene capture view family Ҳһ
+	 */
+	bool HasDeformVelocityThisFrame() const
+	{
+		return PreviousSlice != CurrentSlice;
+	}
+
+	/**
+	 * лslice ֮֡ûµĸ: һ֡transform ǵǰ, velocity ٶɵslice
+	 * ͬһ֡ڵFlush һ
+	 */
+	void SettlePreviousSlice_RenderThread()
+	{
+		if (PreviousSlice == CurrentSlice)
+		{
+			return;
+		}
+
+		if (LastSliceAdvanceFrame != GFrameNumberRenderThread)
+		{
+			PreviousSlice = CurrentSlice;
+			DeformMeshUniformBuffer.UpdateUniformBufferImmediate(GetVFUniformParameters());
+		}
+		else
+		{
+			QueueUploadListener_RenderThread();
+		}
+	}
+
+	/**
+	 *  Ӧsection id transform ֻҪsection array ֵעmark dirty
+	 */
+	void UpateDeformTransofm_RenderThread(int32 SectionIndex, FMatrix DeformTransform)
+	{
+		check(IsInRenderingThread());
+
+		if (Sections.IsValidIndex(SectionIndex) &&
+			Sections[SectionIndex].IsValid())
+		{
+			const int32 slot = Sections[SectionIndex].TransformSlot;
+			DeformTransforms[slot] = DeformTransform;
+			EncodeDeformTransform(TransformEncoding, DeformTransform, &EncodedTransforms[slot * TransformStride]);
+			UpdateSlotWorldBounds(slot);
+			// ÿslice ´дʱҪsection
+			for (TBitArray<>& sliceDirty : SliceDirtyTransforms)
+			{
+				sliceDirty[slot] = true;
+			}
+			bDeformTransformsDirty = true;
+		}
+	}
+
+	/**
+	 * һdrain еһϴʱtrue, ϴ֮
+	 */
+	bool RequestUpload_RenderThread()
+	{
+		const bool bFirstRequest = !bUploadRequested;
+		bUploadRequested = true;
+		return bFirstRequest;
+	}
+
+	/**
+	 * deformer κlocal bounds section deform transform section world bounds
+	 */
+	void UpdateSlotWorldBounds(int32 Slot)
+	{
+		// DeformTransforms дתùľ
+		const FMatrix sectionToWorld = DeformTransforms[Slot].GetTransposed() * GetLocalToWorld();
+		SlotWorldBounds[Slot] = SlotLocalBounds[Slot].TransformBy(sectionToWorld);
+	}
+
+	/**
+	 * component transform , section world bounds Ҫ¼
+	 * ֻbounds  (»section ֮) ʱlocal to world , ʲôҲ
+	 */
+	void OnTransformChanged() override
+	{
+		if (GetLocalToWorld().Equals(LastLocalToWorld, 0.f))
+		{
+			return;
+		}
+		LastLocalToWorld = GetLocalToWorld();
+		LastTransformChangeFrame = GFrameNumberRenderThread;
+
+		for (int32 slot = 0; slot < SlotWorldBounds.Num(); slot++)
+		{
+			UpdateSlotWorldBounds(slot);
+		}
+		UpdateDrawPath_RenderThread();
+
+		// pre deform Ľworld space, section Ҫdeform
+		// һCreateRenderThreadResources ֮ǰ, ʱûbuffer
+		const FDeformTransformRange allSlots = { 0, DeformTransforms.Num() };
+		QueuePreDeform_RenderThread(MakeArrayView(&allSlots, 1));
+	}
+
+	void SetSectionVisibility_RenderThread(int32 SectionIndex, bool bNewVisibility)
+	{
+		check(IsInActualRenderingThread());
+
+		if (Sections.IsValidIndex(SectionIndex) &&
+			Sections[SectionIndex].IsValid())
+		{
+			const int32 slot = Sections[SectionIndex].TransformSlot;
+			if (SlotVisible[slot] != bNewVisibility)
+			{
+				SlotVisible[slot] = bNewVisibility;
+
+				// transform Ӱ, cached mesh draw command Ҫcache
+				if (bUseStaticDrawPath)
+				{
+					GetScene().UpdateCachedRenderStates(this);
+				}
+			}
+		}
+	}
+
+	/**
+	 * AddSection/RemoveSection render command, update queue, ߵļ¼ִʱڶ
+	 * ֮push ļ¼ȱ, ȶӦAddSection/RemoveSection ִ
+	 * ֮ǰpush ļ¼ճ, ֻ֮section index ӹ, Ǹԭsection 
+	 * ɾsection valid, ¼ͲЧ
+	 */
+	bool IsUpdateForCurrentLayout_RenderThread(const FDeformMeshUpdateRecord& Record)
+	{
+		const int16 age = int16(Record.LayoutSerial - AppliedLayoutSerial);
+		if (age > 0)
+		{
+			DeferredUpdates.Add(Record);
+			return false;
+		}
+		if (age < 0 && Sections.IsValidIndex(Record.SectionIndex) &&
+			int16(Sections[Record.SectionIndex].LayoutSerial - Record.LayoutSerial) > 0)
+		{
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * CreateSection: live proxy һRigid section, λѾsection ʱɾ
+	 * γ: ͬmesh Ͳʵgroup Ŀslot, һgroup , group Ŀslot, ½group
+	 * ֻproxy лûеstatic mesh Ŵvertex factory
+	 */
+	void AddSection_RenderThread(const FDeformMeshAddSectionData& Data, uint16 LayoutSerial)
+	{
+		check(IsInRenderingThread());
+		LLM_SCOPE_DEFORM_MESH();
+
+		// оlayout ļ¼drain, IsUpdateForCurrentLayout_RenderThread
+		RemoveSectionSlot_RenderThread(Data.SectionIndex);
+
+		FDeformMeshSourceProxy* source = nullptr;
+		for (FDeformMeshSourceProxy* existingSource : SourceMeshes)
+		{
+			if (existingSource->StaticMesh == Data.StaticMesh && existingSource->DeformerKind == EDeformMeshDeformerKind::Rigid)
+			{
+				source = existingSource;
+				break;
+			}
+		}
+		if (source == nullptr)
+		{
+			source = CreateSourceProxy(Data.StaticMesh, Data.RenderData, EDeformMeshDeformerKind::Rigid);
+		}
+
+#pragma region AssignSlot
+		// ĩβĿslot Ѿȥ, ֻһgroup ûпslot
+		int32 groupIndex = INDEX_NONE;
+		for (int32 i = 0; i < Groups.Num() - 1; i++)
+		{
+			const FDeformMeshSectionGroup& group = Groups[i];
+			if (group.Source == source && group.Material == Data.Material && GetGroupSlotCapacity(i) > group.NumSlots)
+			{
+				groupIndex = i;
+				break;
+			}
+		}
+
+		if (groupIndex == INDEX_NONE && Groups.Num() > 0 && Groups.Last().Source == source && Groups.Last().Material == Data.Material)
+		{
+			groupIndex = Groups.Num() - 1;
+		}
+
+		if (groupIndex == INDEX_NONE)
+		{
+			for (int32 i = 0; i < Groups.Num() - 1; i++)
+			{
+				if (Groups[i].NumSlots == 0 && GetGroupSlotCapacity(i) > 0)
+				{
+					groupIndex = i;
+					break;
+				}
+			}
+
+			if (groupIndex == INDEX_NONE)
+			{
+				groupIndex = Groups.AddDefaulted();
+				Groups[groupIndex].FirstSlot = DeformTransforms.Num();
+				Groups[groupIndex].NumSlots = 0;
+			}
+
+			FDeformMeshSectionGroup& group = Groups[groupIndex];
+			group.Source = source;
+			group.Material = Data.Material;
+			for (FDeformMeshBatchUserData& userData : group.BatchUserData)
+			{
+				userData.PreDeformedBase = 0;
+				userData.DeformerParamBase = 0;
+			}
+		}
+
+		FDeformMeshSectionGroup& group = Groups[groupIndex];
+		const int32 slot = group.FirstSlot + group.NumSlots;
+		group.NumSlots++;
+		if (slot == DeformTransforms.Num())
+		{
+			SetNumSlots_RenderThread(slot + 1);
+		}
+		else
+		{
+			DEC_DWORD_STAT(STAT_DeformMeshEmptySlots);
+		}
+#pragma endregion
+
+		if (Data.SectionIndex >= Sections.Num())
+		{
+			Sections.SetNum(Data.SectionIndex + 1);
+		}
+		Sections[Data.SectionIndex].GroupIndex = groupIndex;
+		Sections[Data.SectionIndex].TransformSlot = slot;
+		Sections[Data.SectionIndex].LayoutSerial = LayoutSerial;
+		SlotSectionIndices[slot] = Data.SectionIndex;
+
+		SlotSources[slot] = source;
+		source->NumLiveSlots++;
+		SlotVisible[slot] = true;
+		SlotLocalBounds[slot] = source->Bounds;
+		DeformTransforms[slot] = Data.DeformTransform;
+		EncodeDeformTransform(TransformEncoding, Data.DeformTransform, &EncodedTransforms[slot * TransformStride]);
+		UpdateSlotWorldBounds(slot);
+		for (TBitArray<>& sliceDirty : SliceDirtyTransforms)
+		{
+			sliceDirty[slot] = true;
+		}
+		bDeformTransformsDirty = true;
+
+		const uint32 indexBytes = source->GetSharedIndexBytes();
+		IndexBytesSaved += indexBytes;
+		INC_MEMORY_STAT_BY(STAT_DeformMeshIndexBytesSaved, indexBytes);
+
+		NumLiveSections++;
+		INC_DWORD_STAT(STAT_DeformMeshSections);
+		INC_DWORD_STAT(STAT_DeformMeshSectionsAddedInPlace);
+
+		MaterialRelevance = Data.MaterialRelevance;
+#if WITH_EDITOR
+		SetUsedMaterialForVerification(Data.UsedMaterials);
+#endif
+
+		FinishLayoutChange_RenderThread(LayoutSerial);
+	}
+
+	/**
+	 * ClearSection: group һsection Ƶɾslot, group 䱣
+	 */
+	void RemoveSection_RenderThread(int32 SectionIndex, uint16 LayoutSerial)
+	{
+		check(IsInRenderingThread());
+
+		RemoveSectionSlot_RenderThread(SectionIndex);
+		FinishLayoutChange_RenderThread(LayoutSerial);
+	}
+
+	void RemoveSectionSlot_RenderThread(int32 SectionIndex)
+	{
+		if (!Sections.IsValidIndex(SectionIndex) || !Sections[SectionIndex].IsValid())
+		{
+			return;
+		}
+
+		FDeformMeshSectionProxy& sectionProxy = Sections[SectionIndex];
+		const int32 slot = sectionProxy.TransformSlot;
+		FDeformMeshSectionGroup& group = Groups[sectionProxy.GroupIndex];
+		FDeformMeshSourceProxy* source = group.Source;
+		sectionProxy = FDeformMeshSectionProxy();
+
+		const int32 lastSlot = group.FirstSlot + group.NumSlots - 1;
+		if (slot != lastSlot)
+		{
+			MoveSlot_RenderThread(lastSlot, slot);
+
+			// deformer pre deform Ľslot , section ƶ
+			const int32 paramStride = GetDeformMeshDeformerParamStride(source->DeformerKind);
+			if (paramStride > 0)
+			{
+				const int32 paramBase = group.BatchUserData[0].DeformerParamBase;
+				FMemory::Memcpy(&DeformerParams[paramBase + slot * paramStride], &DeformerParams[paramBase + lastSlot * paramStride],
+					paramStride * sizeof(FVector4));
+				bDeformerParamsDirty = true;
+			}
+			const FDeformTransformRange movedSlot = { slot, 1 };
+			QueuePreDeform_RenderThread(MakeArrayView(&movedSlot, 1));
+		}
+
+		// slot ɼ, ޳mesh batch 
+		SlotVisible[lastSlot] = false;
+		SlotSources[lastSlot] = nullptr;
+		SlotSectionIndices[lastSlot] = INDEX_NONE;
+		group.NumSlots--;
+		if (group.NumSlots == 0)
+		{
+			group.Source = nullptr;
+		}
+		INC_DWORD_STAT(STAT_DeformMeshEmptySlots);
+
+		const uint32 indexBytes = source->GetSharedIndexBytes();
+		IndexBytesSaved -= indexBytes;
+		DEC_MEMORY_STAT_BY(STAT_DeformMeshIndexBytesSaved, indexBytes);
+
+		NumLiveSections--;
+		DEC_DWORD_STAT(STAT_DeformMeshSections);
+		INC_DWORD_STAT(STAT_DeformMeshSectionsRemovedInPlace);
+
+		if (--source->NumLiveSlots == 0)
+		{
+			RetireSource_RenderThread(source);
+		}
+		TrimTrailingSlots_RenderThread();
+
+		// section index , ĩβɾsection ռλ
+		while (Sections.Num() > 0 && !Sections.Last().IsValid())
+		{
+			Sections.Pop(false);
+		}
+
+		const float compactionFraction = CVarDeformMeshSlotCompaction.GetValueOnRenderThread();
+		const int32 numEmptySlots = DeformTransforms.Num() - NumLiveSections;
+		if (compactionFraction > 0.f && numEmptySlots > 16 && numEmptySlots > DeformTransforms.Num() * compactionFraction)
+		{
+			CompactSlots_RenderThread();
+		}
+	}
+
+	/**
+	 * From section ƵTo, From ݲ, ɵ
+	 */
+	void MoveSlot_RenderThread(int32 From, int32 To)
+	{
+		DeformTransforms[To] = DeformTransforms[From];
+		FMemory::Memcpy(&EncodedTransforms[To * TransformStride], &EncodedTransforms[From * TransformStride],
+			TransformStride * sizeof(FVector4));
+		SlotVisible[To] = (bool)SlotVisible[From];
+		SlotSources[To] = SlotSources[From];
+		SlotLocalBounds[To] = SlotLocalBounds[From];
+		SlotWorldBounds[To] = SlotWorldBounds[From];
+
+		const int32 sectionIndex = SlotSectionIndices[From];
+		SlotSectionIndices[To] = sectionIndex;
+		Sections[sectionIndex].TransformSlot = To;
+
+		for (TBitArray<>& sliceDirty : SliceDirtyTransforms)
+		{
+			sliceDirty[To] = true;
+		}
+		bDeformTransformsDirty = true;
+	}
+
+	/** group Ŀslot Ҳgroup, һgroup ûпslot */
+	inline int32 GetGroupSlotCapacity(int32 GroupIndex) const
+	{
+		const int32 end = GroupIndex + 1 < Groups.Num() ? Groups[GroupIndex + 1].FirstSlot : DeformTransforms.Num();
+		return end - Groups[GroupIndex].FirstSlot;
+	}
+
+	/**
+	 * group Ƶһ, ȥgroup пslot, ҪʱСpool еķ
+	 * pre deform Ľdeformer ƶ, ֻ޸group base, Ҫdeform
+	 */
+	void CompactSlots_RenderThread()
+	{
+		SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshCompactSlots);
+
+		TArray<int32, TInlineAllocator<16>> groupRemap;
+		groupRemap.Init(INDEX_NONE, Groups.Num());
+
+		int32 numSlots = 0;
+		int32 numGroups = 0;
+		for (int32 groupIndex = 0; groupIndex < Groups.Num(); groupIndex++)
+		{
+			FDeformMeshSectionGroup& group = Groups[groupIndex];
+			if (group.NumSlots == 0)
+			{
+				continue;
+			}
+
+			const int32 slotShift = group.FirstSlot - numSlots;
+			if (slotShift > 0)
+			{
+				for (int32 slot = 0; slot < group.NumSlots; slot++)
+				{
+					MoveSlot_RenderThread(group.FirstSlot + slot, numSlots + slot);
+					PendingPreDeformSlots[numSlots + slot] = (bool)PendingPreDeformSlots[group.FirstSlot + slot];
+				}
+
+				const FDeformMeshSourceProxy* source = group.Source;
+				const int32 paramStride = GetDeformMeshDeformerParamStride(source->DeformerKind);
+				for (int32 lodIndex = 0; lodIndex < MAX_STATIC_MESH_LODS; lodIndex++)
+				{
+					FDeformMeshBatchUserData& userData = group.BatchUserData[lodIndex];
+					userData.DeformerParamBase += slotShift * paramStride;
+					if (bUsePreDeform && lodIndex >= source->MinLOD && lodIndex < source->LODs.Num())
+					{
+						userData.PreDeformedBase += slotShift * (source->LODs[lodIndex].MaxVertexIndex + 1);
+					}
+				}
+				group.FirstSlot = numSlots;
+			}
+
+			groupRemap[groupIndex] = numGroups;
+			if (numGroups != groupIndex)
+			{
+				Groups[numGroups] = group;
+			}
+			numGroups++;
+			numSlots += group.NumSlots;
+		}
+
+		Groups.SetNum(numGroups, false);
+		for (FDeformMeshSectionProxy& sectionProxy : Sections)
+		{
+			if (sectionProxy.IsValid())
+			{
+				sectionProxy.GroupIndex = groupRemap[sectionProxy.GroupIndex];
+			}
+		}
+
+		DEC_DWORD_STAT_BY(STAT_DeformMeshEmptySlots, DeformTransforms.Num() - numSlots);
+		SetNumSlots_RenderThread(numSlots);
+		if (SlotCapacity > FMath::Max(numSlots, 16) * 2)
+		{
+			ReallocateTransformSlots_RenderThread(FMath::Max(numSlots, 16));
+		}
+		INC_DWORD_STAT(STAT_DeformMeshSlotCompactions);
+	}
+
+	/**
+	 * source һsection ɾ, group Ѿǿյ
+	 * cached mesh draw command лvertex factory, ؽ֮֡ͷ
+	 */
+	void RetireSource_RenderThread(FDeformMeshSourceProxy* Source)
+	{
+		SourceMeshes.Remove(Source);
+		RetiredSources.Add(Source);
+		RetiredSourcesFrame = GFrameNumberRenderThread;
+		QueueUploadListener_RenderThread();
+	}
+
+	void ReleaseRetiredSources_RenderThread()
+	{
+		for (FDeformMeshSourceProxy* source : RetiredSources)
+		{
+			for (FDeformMeshSourceLOD& sourceLOD : source->LODs)
+			{
+				if (sourceLOD.VertexFactory)
+				{
+					sourceLOD.VertexFactory->ReleaseResource();
+				}
+			}
+			delete source;
+		}
+		RetiredSources.Empty();
+	}
+
+	/**
+	 * ȥĩβĿslot, ĩβĿgroup Ҳȥ, Groups ˳slot ˳
+	 */
+	void TrimTrailingSlots_RenderThread()
+	{
+		while (Groups.Num() > 0 && Groups.Last().NumSlots == 0)
+		{
+			Groups.Pop(false);
+		}
+
+		const int32 numSlots = Groups.Num() > 0 ? Groups.Last().FirstSlot + Groups.Last().NumSlots : 0;
+		DEC_DWORD_STAT_BY(STAT_DeformMeshEmptySlots, DeformTransforms.Num() - numSlots);
+		SetNumSlots_RenderThread(numSlots);
+	}
+
+	/**
+	 * ıаslot ĴС, µslot ɵд
+	 */
+	void SetNumSlots_RenderThread(int32 NumSlots)
+	{
+		const int32 oldNumSlots = DeformTransforms.Num();
+		if (NumSlots == oldNumSlots)
+		{
+			return;
+		}
+
+		if (NumSlots > SlotCapacity)
+		{
+			ReallocateTransformSlots_RenderThread(FMath::Max3(NumSlots, SlotCapacity * 2, 16));
+		}
+
+		auto resizeBits = [NumSlots, oldNumSlots](TBitArray<>& Bits)
+		{
+			if (NumSlots > oldNumSlots)
+			{
+				Bits.Add(false, NumSlots - oldNumSlots);
+			}
+			else
+			{
+				Bits.RemoveAt(NumSlots, oldNumSlots - NumSlots);
+			}
+		};
+
+		DeformTransforms.SetNum(NumSlots, false);
+		EncodedTransforms.SetNum(NumSlots * TransformStride, false);
+		SlotSources.SetNumZeroed(NumSlots, false);
+		SlotSectionIndices.SetNum(NumSlots, false);
+		SlotLocalBounds.SetNumZeroed(NumSlots, false);
+		SlotWorldBounds.SetNumZeroed(NumSlots, false);
+		resizeBits(SlotVisible);
+		for (TBitArray<>& sliceDirty : SliceDirtyTransforms)
+		{
+			resizeBits(sliceDirty);
+		}
+		resizeBits(PendingPreDeformSlots);
+	}
+
+	/**
+	 * slot SlotCapacity ʱpool ·, ÿslice д뵱ǰtransform
+	 * µλÿһpage, cached mesh draw command еSRV FinishLayoutChange_RenderThread ؽ
+	 */
+	void ReallocateTransformSlots_RenderThread(int32 NewCapacity)
+	{
+		// ûCreateRenderThreadResources, ʱµ
+		if (!DeformMeshUniformBuffer.IsValid())
+		{
+			SlotCapacity = NewCapacity;
+			return;
+		}
+
+		DEC_MEMORY_STAT_BY(STAT_DeformMeshProxyGPUBytes, GetGPUAllocatedSize());
+		GDeformMeshTransformPool.Free(TransformAllocation);
+
+		SlotCapacity = NewCapacity;
+		TransformAllocation = GDeformMeshTransformPool.Allocate(TransformBufferDepth * SlotCapacity);
+		const int32 numSlots = DeformTransforms.Num();
+		if (numSlots > 0)
+		{
+			for (int32 slice = 0; slice < TransformBufferDepth; slice++)
+			{
+				GDeformMeshTransformPool.Write(TransformAllocation, slice * SlotCapacity, EncodedTransforms.GetData(), numSlots);
+			}
+		}
+		INC_MEMORY_STAT_BY(STAT_DeformMeshProxyGPUBytes, GetGPUAllocatedSize());
+
+		DeformMeshUniformBuffer.UpdateUniformBufferImmediate(GetVFUniformParameters());
+	}
+
+	/**
+	 * ӻɾsection ֮: Ƴٵļ¼, ϴcache һ֡drain
+	 */
+	void FinishLayoutChange_RenderThread(uint16 LayoutSerial)
+	{
+		AppliedLayoutSerial = LayoutSerial;
+		if (DeferredUpdates.Num() > 0)
+		{
+			// ֮layout ļ¼¼DeferredUpdates
+			TArray<FDeformMeshUpdateRecord> deferredUpdates = MoveTemp(DeferredUpdates);
+			DeferredUpdates.Reset();
+			for (const FDeformMeshUpdateRecord& record : deferredUpdates)
+			{
+				ApplyDeformMeshUpdateRecord_RenderThread(record);
+			}
+		}
+
+		QueueSlotsChanged_RenderThread();
+	}
+
+	/**
+	 * CompactSections: ȿslot ﵽ r.DeformMesh.SlotCompaction ѹ
+	 */
+	void CompactSlotsNow_RenderThread()
+	{
+		check(IsInRenderingThread());
+		if (DeformTransforms.Num() > NumLiveSections || SlotCapacity > FMath::Max(DeformTransforms.Num(), 16) * 2)
+		{
+			CompactSlots_RenderThread();
+			QueueSlotsChanged_RenderThread();
+		}
+	}
+
+	/**
+	 * ͬһ֡Ķsection 仯ֻdrain дһ, ϴҲproxy дϲһFlush
+	 * ֮ǰGPU ϵtransform cached mesh draw command Ǳ仯֮ǰ
+	 */
+	void QueueSlotsChanged_RenderThread()
+	{
+		if (!bSlotsChangedQueued)
+		{
+			GDeformMeshSlotsChangedProxies.Add(this);
+			bSlotsChangedQueued = true;
+		}
+	}
+
+	/**
+	 * slot , ɾƶ֮: дµtransform, ´deformer , cache mesh draw command
+	 * drain Flush ϴ
+	 */
+	void OnSlotsChanged_RenderThread()
+	{
+		bSlotsChangedQueued = false;
+		UpdateDeformTransformSB_RenderThread();
+		if (bDeformerParamsDirty)
+		{
+			DEC_MEMORY_STAT_BY(STAT_DeformMeshProxyGPUBytes, GetGPUAllocatedSize());
+			CreateDeformerParamsBuffer_RenderThread();
+			INC_MEMORY_STAT_BY(STAT_DeformMeshProxyGPUBytes, GetGPUAllocatedSize());
+		}
+		UpdateCPUAllocatedSize();
+
+		// section , Ҫpath, path ʱѾcache
+		const bool bWasUsingStaticDrawPath = bUseStaticDrawPath;
+		UpdateDrawPath_RenderThread();
+		if (bUseStaticDrawPath && bWasUsingStaticDrawPath)
+		{
+			GetScene().UpdateCachedRenderStates(this);
+		}
+	}
+
+	/**
+	 * section view еĻߴѡLOD, static mesh LOD ѡʽһ, ټcomponent LODBias
+	 */
+	int32 ComputeSectionLOD(const FDeformMeshSourceProxy& Source, int32 Slot, const FSceneView& View) const
+	{
+		const FBoxSphereBounds& bounds = SlotWorldBounds[Slot];
+		const float screenRadiusSquared = ComputeBoundsScreenRadiusSquared(bounds.Origin, bounds.SphereRadius, View);
+
+		int32 lodIndex = Source.MinLOD;
+		for (int32 i = Source.LODs.Num() - 1; i > Source.MinLOD; i--)
+		{
+			if (FMath::Square(Source.LODs[i].ScreenSize * 0.5f) > screenRadiusSquared)
+			{
+				lodIndex = i;
+				break;
+			}
+		}
+		return FMath::Clamp(lodIndex + LODBias, Source.MinLOD, Source.LODs.Num() - 1);
+	}
+
+	/**
+	 * һview ޳section û޳section ѡLOD, дOutSlotLODs, ޳DeformSectionCulled
+	 * max draw distance, view frustum (shadow ռʱshadow frustum) ÿsection world bounds
+	 * section ʱParallelFor, FConvexVolume::IntersectBox SIMD ʵ
+	 */
+	void CullSections(const FSceneView& View, TArray<uint8, TInlineAllocator<64>>& OutSlotLODs) const
+	{
+		const int32 numSlots = SlotWorldBounds.Num();
+		OutSlotLODs.SetNumUninitialized(numSlots, false);
+
+		// shadow depth pass ռdynamic mesh ʱfrustum
+		const FConvexVolume* shadowFrustum = View.GetDynamicMeshElementsShadowCullFrustum();
+		const FConvexVolume& cullFrustum = shadowFrustum ? *shadowFrustum : View.ViewFrustum;
+		const FVector cullTranslation = shadowFrustum ? View.GetPreShadowTranslation() : FVector::ZeroVector;
+
+		const FVector viewOrigin = View.ViewMatrices.GetViewOrigin();
+		const float maxDrawDistance = GetMaxDrawDistance();
+
+		auto cullSlot = [this, &View, &OutSlotLODs, &cullFrustum, &cullTranslation, &viewOrigin, maxDrawDistance](int32 Slot)
+		{
+			const FBoxSphereBounds& bounds = SlotWorldBounds[Slot];
+			const bool bCulled = !SlotVisible[Slot] ||
+				FVector::Dist(bounds.Origin, viewOrigin) - bounds.SphereRadius > maxDrawDistance ||
+				!cullFrustum.IntersectBox(bounds.Origin + cullTranslation, bounds.BoxExtent);
+
+			OutSlotLODs[Slot] = bCulled ? DeformSectionCulled : (uint8)ComputeSectionLOD(*SlotSources[Slot], Slot, View);
+		};
+
+		if (numSlots >= CVarDeformMeshParallelCullMinSections.GetValueOnRenderThread())
+		{
+			ParallelFor(numSlots, cullSlot);
+		}
+		else
+		{
+			for (int32 slot = 0; slot < numSlots; slot++)
+			{
+				cullSlot(slot);
+			}
+		}
+	}
+
+	/**
+	 * һgroup mesh batch, static  dynamic path 
+	 * group ÿһĿɼslot һbatch element, instancing ,
+	 * UserIndex һεĵһslot, shader DMTransformIndex
+	 * SlotLODs ΪʱֻCullSections ѡLODIndex section, slot 
+	 * primitive uniform buffer ɵ, ûпɼsection ʱfalse
+	 */
+	bool SetupGroupMeshBatch(const FDeformMeshSectionGroup& Group, int32 LODIndex, const uint8* SlotLODs,
+		FMaterialRenderProxy* MaterialProxy, bool bWireframe, FMeshBatch& MeshBatch) const
+	{
+		const FDeformMeshSourceLOD& sourceLOD = Group.Source->LODs[LODIndex];
+
+		auto isSlotDrawn = [this, LODIndex, SlotLODs](int32 Slot)
+		{
+			return SlotLODs ? SlotLODs[Slot] == LODIndex : (bool)SlotVisible[Slot];
+		};
+
+		MeshBatch.Elements.Reset();
+		const int32 endSlot = Group.FirstSlot + Group.NumSlots;
+		for (int32 slot = Group.FirstSlot; slot < endSlot;)
+		{
+			if (!isSlotDrawn(slot))
+			{
+				slot++;
+				continue;
+			}
+
+			int32 runEnd = slot + 1;
+			while (runEnd < endSlot && isSlotDrawn(runEnd))
+			{
+				runEnd++;
+			}
+
+			FMeshBatchElement& batchElement = MeshBatch.Elements.AddDefaulted_GetRef();
+			batchElement.IndexBuffer = sourceLOD.IndexBuffer;
+			batchElement.FirstIndex = 0;
+			batchElement.NumPrimitives = sourceLOD.NumPrimitives;
+			batchElement.MinVertexIndex = 0;
+			batchElement.MaxVertexIndex = sourceLOD.MaxVertexIndex;
+			batchElement.NumInstances = runEnd - slot;
+			batchElement.UserIndex = slot;
+			// pre deform ͷRigid deformer ʱvertex factory Żȡ
+			batchElement.UserData = &Group.BatchUserData[LODIndex];
+
+			slot = runEnd;
+		}
+
+		if (MeshBatch.Elements.Num() == 0)
+		{
+			return false;
+		}
+
+		MeshBatch.bWireframe = bWireframe;
+		MeshBatch.VertexFactory = sourceLOD.VertexFactory.Get();
+		MeshBatch.LODIndex = LODIndex;
+		MeshBatch.MaterialRenderProxy = MaterialProxy;
+		MeshBatch.ReverseCulling = IsLocalToWorldDeterminantNegative();
+		MeshBatch.Type = PT_TriangleList;
+		MeshBatch.DepthPriorityGroup = SDPG_World;
+		MeshBatch.bCanApplyViewModeOverrides = false;
+		return true;
+	}
+
+	/**
+	 * Cached path: mesh batch ֻproxy scene  UpdateCachedRenderStates ʱһ,
+	 * deform ȫDMTransforms , ÿ֡Ҫؽ
+	 * 4.26 ֻcache ֻһelement mesh batch, ÿĿɼslot һmesh batch,
+	 * ÿLOD ύһ, renderer primitive ĻߴѡLOD,
+	 * LOD per component , per section LOD ޳ֻdynamic path 
+	 */
+	void DrawStaticElements(FStaticPrimitiveDrawInterface* PDI) override
+	{
+		if (!bUseStaticDrawPath)
+		{
+			return;
+		}
+
+		DEC_DWORD_STAT_BY(STAT_DeformMeshCachedBatches, NumCachedMeshBatches);
+		NumCachedMeshBatches = 0;
+
+		for (int32 groupIndex = 0; groupIndex < Groups.Num(); groupIndex++)
+		{
+			const FDeformMeshSectionGroup& group = Groups[groupIndex];
+			if (group.Source == nullptr)
+			{
+				continue;
+			}
+
+			const FDeformMeshSourceProxy* source = group.Source;
+			for (int32 lodIndex = 0; lodIndex < source->LODs.Num(); lodIndex++)
+			{
+				// LODBias ÿĻߴʹø;ȵLOD
+				const int32 drawLODIndex = FMath::Clamp(lodIndex + LODBias, source->MinLOD, source->LODs.Num() - 1);
+
+				FMeshBatch groupBatch;
+				if (!SetupGroupMeshBatch(group, drawLODIndex, nullptr, group.Material->GetRenderProxy(), false, groupBatch))
+				{
+					continue;
+				}
+
+				groupBatch.LODIndex = lodIndex;
+				groupBatch.SegmentIndex = groupIndex;
+				groupBatch.CastShadow = true;
+				const float screenSize = source->LODs.Num() > 1 ? source->LODs[lodIndex].ScreenSize : FLT_MAX;
+				for (const FMeshBatchElement& runElement : groupBatch.Elements)
+				{
+					FMeshBatch runBatch(groupBatch);
+					runBatch.Elements.SetNum(1);
+					runBatch.Elements[0] = runElement;
+					runBatch.Elements[0].PrimitiveUniformBuffer = GetUniformBuffer();
+
+					PDI->DrawMesh(runBatch, screenSize);
+					NumCachedMeshBatches++;
+				}
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_DeformMeshCachedBatches, NumCachedMeshBatches);
+	}
+
+	/**
+	 * viewsvisiblityMap,ҪMeshBatch
+	 */
+	void GetDynamicMeshElements(const TArray<const FSceneView*>& Views,
+		const FSceneViewFamily& ViewFamily, uint32 VisibilityMap,
+		class FMeshElementCollector& Collector) const override
+	{
+		SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshGetDynamicMeshElements);
+
+		const bool bUseWireframe = AllowDebugViewmodes() &&
+			ViewFamily.EngineShowFlags.Wireframe;
+
+		FColoredMaterialRenderProxy* wireframeMaterialInstance = nullptr;
+		if (bUseWireframe)
+		{
+			wireframeMaterialInstance = new FColoredMaterialRenderProxy(
+				GEngine->WireframeMaterial ? GEngine->WireframeMaterial->GetRenderProxy() : nullptr,
+				FLinearColor(0.f, 0.5f, 1.f)
+			);
+
+			// proxyڴչcollector
+			Collector.RegisterOneFrameMaterialProxy(wireframeMaterialInstance);
+		}
+
+		// ÿslot ڵǰview ѡеLOD, slot 
+		TArray<uint8, TInlineAllocator<64>> slotLODs;
+
+		// foreach view
+		for (int32 viewIndex = 0; viewIndex < Views.Num(); viewIndex++)
+		{
+			// meshԵǰviewǷɼ
+			bool bVisibleToView = VisibilityMap & (1 << viewIndex);
+			if (!bVisibleToView)
+			{
+				continue;
+			}
+
+			const FSceneView* sceneView = Views[viewIndex];
+
+			// ڷmesh batch ֮ǰ޳section
+			CullSections(*sceneView, slotLODs);
+
+			// LocalVertexFactory һuniform buffer 
+			// localToWorld previousLocalToWorldȵ, 󲿷ֶhelper function
+			// ͬһview mesh batch һ
+			bool bHasPrecomputedVolumetricLightmap;
+			FMatrix prevousLocalToWorld;
+			int32 singleCaptureIndex;
+			bool bOutputVelocity;
+			GetScene().GetPrimitiveUniformShaderParameters_RenderThread(
+				GetPrimitiveSceneInfo(),
+				bHasPrecomputedVolumetricLightmap,
+				prevousLocalToWorld,
+				singleCaptureIndex,
+				bOutputVelocity
+			);
+			FDynamicPrimitiveUniformBuffer& dynamicUniformBuffer =
+				Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+			// һʱprimitive uniform buffer, õbatchElement
+			dynamicUniformBuffer.Set(GetLocalToWorld(),
+				prevousLocalToWorld,
+				GetBounds(), GetLocalBounds(),
+				true, bHasPrecomputedVolumetricLightmap,
+				DrawsVelocity(), bOutputVelocity);
+
+			for (const FDeformMeshSectionGroup& group : Groups)
+			{
+				if (group.Source == nullptr)
+				{
+					continue;
+				}
+
+				FMaterialRenderProxy* materialProxy = bUseWireframe ?
+					wireframeMaterialInstance : group.Material->GetRenderProxy();
+
+				// ¼group õЩLOD
+				const FDeformMeshSourceProxy& source = *group.Source;
+				uint32 usedLODMask = 0;
+				uint32 numTested = 0;
+				uint32 numDrawn = 0;
+				for (int32 slot = group.FirstSlot; slot < group.FirstSlot + group.NumSlots; slot++)
+				{
+					numTested += SlotVisible[slot] ? 1 : 0;
+					if (slotLODs[slot] != DeformSectionCulled)
+					{
+						usedLODMask |= 1u << slotLODs[slot];
+						numDrawn++;
+					}
+				}
+				INC_DWORD_STAT_BY(STAT_DeformMeshSectionsTested, numTested);
+				INC_DWORD_STAT_BY(STAT_DeformMeshSectionsCulled, numTested - numDrawn);
+				INC_DWORD_STAT_BY(STAT_DeformMeshSectionsDrawn, numDrawn);
+
+				// ÿõLOD һmesh batch
+				for (int32 lodIndex = source.MinLOD; lodIndex < source.LODs.Num(); lodIndex++)
+				{
+					if ((usedLODMask & (1u << lodIndex)) == 0)
+					{
+						continue;
+					}
+
+#pragma region ContructMeshBatch
+					FMeshBatch& meshBatch = Collector.AllocateMesh();
+#pragma endregion
+					SetupGroupMeshBatch(group, lodIndex, slotLODs.GetData(), materialProxy, bUseWireframe, meshBatch);
+
+					uint32 numTriangles = 0;
+					for (FMeshBatchElement& batchElement : meshBatch.Elements)
+					{
+						batchElement.PrimitiveUniformBufferResource = &dynamicUniformBuffer.UniformBuffer;
+						batchElement.PrimitiveIdMode = PrimID_DynamicPrimitiveShaderData;
+						numTriangles += batchElement.NumPrimitives * batchElement.NumInstances;
+					}
+
+					//add batch to collector
+					Collector.AddMesh(viewIndex, meshBatch);
+					INC_DWORD_STAT_BY(STAT_DeformMeshDynamicBatches, meshBatch.Elements.Num());
+					IncDeformMeshTrianglesStat(lodIndex, numTriangles);
+				}
+			}
+		}
+	}
+
+	/**
+	 * benchmark : ظNumIterations GetDynamicMeshElements бsection Ĳ,
+	 * CullSections ÿgroup ÿõLOD SetupGroupMeshBatch, collector
+	 * ÿεƽ, OutNumBatchElements һɵbatch element 
+	 */
+	double TimeSectionIteration_RenderThread(const FSceneView& View, int32 NumIterations, int32& OutNumBatchElements) const
+	{
+		check(IsInRenderingThread());
+
+		TArray<uint8, TInlineAllocator<64>> slotLODs;
+		FMeshBatch meshBatch;
+		int32 numBatchElements = 0;
+		const double start = FPlatformTime::Seconds();
+		for (int32 iteration = 0; iteration < NumIterations; iteration++)
+		{
+			numBatchElements = 0;
+			CullSections(View, slotLODs);
+			for (const FDeformMeshSectionGroup& group : Groups)
+			{
+				if (group.Source == nullptr)
+				{
+					continue;
+				}
+
+				uint32 usedLODMask = 0;
+				for (int32 slot = group.FirstSlot; slot < group.FirstSlot + group.NumSlots; slot++)
+				{
+					if (slotLODs[slot] != DeformSectionCulled)
+					{
+						usedLODMask |= 1u << slotLODs[slot];
+					}
+				}
+
+				for (int32 lodIndex = group.Source->MinLOD; lodIndex < group.Source->LODs.Num(); lodIndex++)
+				{
+					if ((usedLODMask & (1u << lodIndex)) != 0 &&
+						SetupGroupMeshBatch(group, lodIndex, slotLODs.GetData(), group.Material->GetRenderProxy(), false, meshBatch))
+					{
+						numBatchElements += meshBatch.Elements.Num();
+					}
+				}
+			}
+		}
+		const double seconds = FPlatformTime::Seconds() - start;
+
+		OutNumBatchElements = numBatchElements;
+		return seconds * 1000.0 / FMath::Max(NumIterations, 1);
+	}
+
+	FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance res;
+		res.bDrawRelevance = IsShown(View);
+		res.bShadowRelevance = IsShadowCast(View);
+		// wireframe Ҫoverride material, ֻdynamic path
+		const bool bWireframe = AllowDebugViewmodes() && View->Family->EngineShowFlags.Wireframe;
+		res.bStaticRelevance = bUseStaticDrawPath && !bWireframe;
+		res.bDynamicRelevance = !res.bStaticRelevance;
+		res.bRenderInMainPass = ShouldRenderInMainPass();
+		res.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
+		res.bRenderCustomDepth = ShouldRenderCustomDepth();
+		res.bTranslucentSelfShadow = bCastVolumetricTranslucentShadow;
+		// cachecan be occluded
+		MaterialRelevance.SetPrimitiveViewRelevance(res);
+		// bAlwaysHasVelocity ʱrenderer ټcomponent Ƿƶ, ųһ֡ûб仯component
+		// view relevance ÿ֡, static dynamic path һ
+		const bool bHasVelocity = bAlwaysHasVelocity ?
+			HasDeformVelocityThisFrame() || (IsMovable() && LastTransformChangeFrame == GFrameNumberRenderThread) :
+			IsMovable();
+		res.bVelocityRelevance = bHasVelocity && res.bOpaque && res.bRenderInMainPass;
+		return res;
+	}
+
+	bool CanBeOccluded() const override
+	{
+		return !MaterialRelevance.bDisableDepthTest;
+	}
+
+
+	/**
+	 * proxy ӵеCPU ڴ, sizeof(*this)
+	 * index buffer vertex buffer static mesh , , ʡµڴGetIndexBytesSaved
+	 */
+	uint32 GetAllocatedSize(void) const
+	{
+		uint32 sourceSize = SourceMeshes.GetAllocatedSize();
+		for (const FDeformMeshSourceProxy* source : SourceMeshes)
+		{
+			sourceSize += sizeof(FDeformMeshSourceProxy) + source->LODs.GetAllocatedSize();
+			for (const FDeformMeshSourceLOD& sourceLOD : source->LODs)
+			{
+				sourceSize += sizeof(FDeformMeshSourceLOD);
+				if (sourceLOD.VertexFactory)
+				{
+					sourceSize += sizeof(FDeformMeshVertexFactory);
+				}
+			}
+		}
+
+		uint32 sliceDirtySize = SliceDirtyTransforms.GetAllocatedSize();
+		for (const TBitArray<>& sliceDirty : SliceDirtyTransforms)
+		{
+			sliceDirtySize += sliceDirty.GetAllocatedSize();
+		}
+
+		return (FPrimitiveSceneProxy::GetAllocatedSize()
+			+ Sections.GetAllocatedSize()
+			+ sourceSize
+			+ Groups.GetAllocatedSize()
+			+ SlotVisible.GetAllocatedSize()
+			+ SlotSources.GetAllocatedSize()
+			+ SlotSectionIndices.GetAllocatedSize()
+			+ SlotLocalBounds.GetAllocatedSize()
+			+ SlotWorldBounds.GetAllocatedSize()
+			+ DeformerParams.GetAllocatedSize()
+			+ DeformTransforms.GetAllocatedSize()
+			+ EncodedTransforms.GetAllocatedSize()
+			+ sliceDirtySize
+			+ DirtyRanges.GetAllocatedSize()
+			+ PendingPreDeformSlots.GetAllocatedSize());
+	}
+
+	/**
+	 * proxy GPU buffer ĴС, CreateRenderThreadResources ֮ǰ0
+	 */
+	uint32 GetGPUAllocatedSize() const
+	{
+		// õpool proxy ռõĲ
+		uint32 size = TransformAllocation.Num * TransformStride * sizeof(FVector4);
+		if (DeformerParamsSB)
+		{
+			size += DeformerParamsSB->GetSize();
+		}
+		if (PreDeformedPositionsVB)
+		{
+			size += PreDeformedPositionsVB->GetSize();
+		}
+		if (DeformMeshUniformBuffer)
+		{
+			size += sizeof(FDeformMeshVFUniformParameters);
+		}
+		return size;
+	}
+
+	/** static mesh index buffer ÿsection һʡµڴ */
+	inline uint32 GetIndexBytesSaved() const { return IndexBytesSaved; }
+
+	inline FRHIShaderResourceView* GetDeformTransformsSRV() const { return GDeformMeshTransformPool.GetSRV(TransformAllocation); }
+
+	inline const TUniformBufferRef<FDeformMeshVFUniformParameters>& GetDeformMeshUniformBuffer() const { return DeformMeshUniformBuffer; }
+
+	inline FShaderResourceViewRHIRef& GetPreDeformedPositionsSRV() { return PreDeformedPositionsSRV; }
+
+	inline FShaderResourceViewRHIRef& GetDeformerParamsSRV() { return DeformerParamsSRV; }
+
+	/**
+	 * PreDeformedPositions CPU 汾DeformMeshPreDeformPosition Ƚ, 
+	 * stall GPU, ֻڵ (r.DeformMesh.ValidatePreDeform)
+	 */
+	void ValidatePreDeform_RenderThread(FRHICommandListImmediate& RHICmdList)
+	{
+		if (!PreDeformedPositionsVB)
+		{
+			UE_LOG(LogDeformMesh, Log, TEXT("%s: pre deform is not used"), *GetOwnerName().ToString());
+			return;
+		}
+
+		// Ȱѻûϴtransform ϴdeform, DeformTransforms Բ
+		// ûUpload ¼dirty transform, drain ֮дһ
+		DrainDeformMeshUpdateQueue_RenderThread();
+		UpdateDeformTransformSB_RenderThread();
+		GDeformMeshTransformPool.Flush(RHICmdList);
+
+		const uint32 numBytes = NumPreDeformedVertices * 3 * sizeof(float);
+		const float* gpuPositions = (const float*)RHILockVertexBuffer(PreDeformedPositionsVB, 0, numBytes, RLM_ReadOnly);
+
+		float maxError = 0.f;
+		int32 numChecked = 0;
+		int32 numSkippedLODs = 0;
+		for (const FDeformMeshSectionGroup& group : Groups)
+		{
+			const FDeformMeshSourceProxy* source = group.Source;
+			if (source == nullptr)
+			{
+				continue;
+			}
+			for (int32 lodIndex = source->MinLOD; lodIndex < source->LODs.Num(); lodIndex++)
+			{
+				const FDeformMeshSourceLOD& sourceLOD = source->LODs[lodIndex];
+				// cook ֮static mesh һCPU ˵Ķ
+				if (sourceLOD.PositionBuffer->GetVertexData() == nullptr)
+				{
+					numSkippedLODs++;
+					continue;
+				}
+
+				const int32 numVertices = sourceLOD.MaxVertexIndex + 1;
+				const FDeformMeshBatchUserData& userData = group.BatchUserData[lodIndex];
+				const int32 paramStride = GetDeformMeshDeformerParamStride(source->DeformerKind);
+				for (int32 slot = group.FirstSlot; slot < group.FirstSlot + group.NumSlots; slot++)
+				{
+					const FVector4* slotParams = paramStride > 0 ? &DeformerParams[userData.DeformerParamBase + slot * paramStride] : nullptr;
+					for (int32 vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
+					{
+						const FVector localPosition = ApplyDeformMeshDeformer(source->DeformerKind, slotParams,
+							sourceLOD.PositionBuffer->VertexPosition(vertexIndex));
+						const FVector expected = DeformMeshPreDeformPosition(localPosition, DeformTransforms[slot], GetLocalToWorld());
+						const int32 index = (userData.PreDeformedBase + slot * numVertices + vertexIndex) * 3;
+						const FVector actual(gpuPositions[index], gpuPositions[index + 1], gpuPositions[index + 2]);
+						maxError = FMath::Max(maxError, FVector::Dist(expected, actual));
+						numChecked++;
+					}
+				}
+			}
+		}
+
+		RHIUnlockVertexBuffer(PreDeformedPositionsVB);
+
+		UE_LOG(LogDeformMesh, Log, TEXT("%s: %d pre deformed positions checked, max error %f, %d LODs without CPU data skipped"),
+			*GetOwnerName().ToString(), numChecked, maxError, numSkippedLODs);
+	}
+
+	virtual uint32 GetMemoryFootprint(void) const override
+	{
+		return (sizeof(*this) + GetAllocatedSize());
+	}
+
+
+private:
+	// section index , 
+	TArray<FDeformMeshSectionProxy> Sections;
+
+	// ÿͬstatic mesh һ
+	TArray<FDeformMeshSourceProxy*> SourceMeshes;
+
+	// ÿ(static mesh, material) һ, ÿgroup һmesh batch
+	TArray<FDeformMeshSectionGroup> Groups;
+
+	// transform slot section ɼ
+	TBitArray<> SlotVisible;
+
+	// transform slot source mesh, ûsection Ŀslot nullptr
+	TArray<const FDeformMeshSourceProxy*> SlotSources;
+
+	// transform slot section index, ƶslot ʱSections, slot INDEX_NONE
+	TArray<int32> SlotSectionIndices;
+
+	// transform slot section local bounds, ûгdeform transform
+	// Rigid static mesh bounds, deformer Ǳ֮
+	TArray<FBoxSphereBounds> SlotLocalBounds;
+
+	// transform slot section world bounds, per section ޳LOD ѡ
+	TArray<FBoxSphereBounds> SlotWorldBounds;
+
+	// GetIndexBytesSaved
+	uint32 IndexBytesSaved = 0;
+
+	// ʱGetAllocatedSize, STAT_DeformMeshProxyCPUBytes
+	uint32 CPUAllocatedSize = 0;
+
+
+	FMaterialRelevance MaterialRelevance;
+
+	//  ÿsection вͬdeform transform, transform slot 
+	// render thread bounds , ϴEncodedTransforms
+	TArray<FMatrix> DeformTransforms;
+
+	// TransformEncoding DeformTransforms, ÿslot TransformStride float4
+	TArray<FVector4> EncodedTransforms;
+
+	// GDeformMeshTransformPool еslot, 󶨵vertex factory page SRV
+	FDeformMeshTransformAllocation TransformAllocation;
+
+	// structed buffersǷҪµdirty flag
+	bool bDeformTransformsDirty;
+
+	// ÿslice ÿsection һdirty bit, ϴʱϲ
+	TArray<TBitArray<>> SliceDirtyTransforms;
+
+	// BuildDirtyRanges , ΪԱڴ
+	TArray<FDeformTransformRange> DirtyRanges;
+
+	// ȴpool Flush ֮pre deform slot
+	TBitArray<> PendingPreDeformSlots;
+
+	// ѾGDeformMeshTransformPool listener , ȴpre deform ͷRetiredSources
+	bool bUploadListenerQueued;
+
+	// һdrain update queue FinishDeformUpdate
+	bool bUploadRequested;
+
+	// GDeformMeshSlotsChangedProxies , һdrain
+	bool bSlotsChangedQueued = false;
+
+	// r.DeformMesh.CacheStaticDraw Ϊ0 ʱһֱfalse, UpdateDrawPath_RenderThread section ͷֲ
+	bool bUseStaticDrawPath;
+
+	// һDrawStaticElements cache mesh batch , stat
+	uint32 NumCachedMeshBatches;
+
+	// TransformAllocation slice ,  r.DeformMesh.TransformBufferDepth
+	const int32 TransformBufferDepth;
+
+	// component LODBias, ӵĻߴѡLOD 
+	const int32 LODBias;
+
+	//  r.DeformMesh.TransformEncoding, ͱshader ʱһ
+	const EDeformTransformEncoding TransformEncoding;
+
+	// һslot EncodedTransforms DMTransforms ռfloat4
+	const int32 TransformStride;
+
+	// TransformAllocation ÿslice slot , section ʱ·
+	int32 SlotCapacity;
+
+	// section slot , group ֮Ŀslot
+	int32 NumLiveSections;
+
+	// һsection ɾsource, cached mesh draw command ؽ֮ͷ
+	TArray<FDeformMeshSourceProxy*> RetiredSources;
+	uint32 RetiredSourcesFrame = 0;
+
+	// һOnTransformChanged local to world
+	FMatrix LastLocalToWorld = FMatrix(ForceInitToZero);
+
+	// local to world һα仯֡, ֻһ֡component Լƶvelocity
+	uint32 LastTransformChangeFrame = 0;
+
+	// һִеAddSection/RemoveSection ӦInPlaceSectionSerial
+	uint16 AppliedLayoutSerial;
+
+	// serial AppliedLayoutSerial µļ¼, ȶӦsection 仯ִ֮ٴ
+	TArray<FDeformMeshUpdateRecord> DeferredUpdates;
+
+	// vertex factory ǰȡslice
+	int32 CurrentSlice;
+
+	// LastSliceAdvanceFrame һ֮֡ǰslice, velocity һ֡λ, ֮֡CurrentSlice
+	int32 PreviousSlice;
+
+	// һлslice ֡, ͬһ֡ڶθдͬһslice
+	uint32 LastSliceAdvanceFrame;
+
+	// 浱ǰslice ʼλ, 󶨵vertex factory
+	TUniformBufferRef<FDeformMeshVFUniformParameters> DeformMeshUniformBuffer;
+
+	//  r.DeformMesh.PreDeform, ͱshader ʱһ
+	const bool bUsePreDeform;
+
+	// group LOD Ķ֮, ÿsection һ
+	int32 NumPreDeformedVertices;
+
+	// pre deform compute shader world space λ, ÿ3 float
+	// ֻGPU ϰ˳д, ԲҪDMTransforms һslice
+	FVertexBufferRHIRef PreDeformedPositionsVB;
+	FShaderResourceViewRHIRef PreDeformedPositionsSRV;
+	FUnorderedAccessViewRHIRef PreDeformedPositionsUAV;
+
+	// зRigid section deformer , group slot , ּPackDeformMeshDeformerParams
+	TArray<FVector4> DeformerParams;
+	FStructuredBufferRHIRef DeformerParamsSB;
+	FShaderResourceViewRHIRef DeformerParamsSRV;
+
+	// slot ƶʱDeformerParams , OnSlotsChanged_RenderThread ´DeformerParamsSB
+	bool bDeformerParamsDirty = false;
+};
+
+//#Unkown ɶ Mannual fetch
 class FDeformMeshVertexFactoryShaderParameters : public FVertexFactoryShaderParameters
 {
 	// #Unkown Ǹɶ
@@ -510,6 +2736,11 @@ public:
 	{
 		TransformIndex.Bind(ParameterMap, TEXT("DMTransformIndex"), SPF_Optional);
 		TransformSRV.Bind(ParameterMap, TEXT("DMTransforms"), SPF_Optional);
+		PreDeformedPositions.Bind(ParameterMap, TEXT("DMPreDeformedPositions"), SPF_Optional);
+		PreDeformedBase.Bind(ParameterMap, TEXT("DMPreDeformedBase"), SPF_Optional);
+		PreDeformedNumVertices.Bind(ParameterMap, TEXT("DMPreDeformedNumVertices"), SPF_Optional);
+		DeformerParams.Bind(ParameterMap, TEXT("DMDeformerParams"), SPF_Optional);
+		DeformerParamBase.Bind(ParameterMap, TEXT("DMDeformerParamBase"), SPF_Optional);
 	}
 
 	/**
@@ -543,115 +2774,676 @@ public:
 
 		const FDeformMeshVertexFactory* deformMeshVertexFactory = (FDeformMeshVertexFactory*)(VertexFactory);
 
-		//deform mesh vertexFactoryжȡҪıӵshadering binding
-		const uint32 index = deformMeshVertexFactory->TransformIndex;
+		//batch element  deform mesh vertexFactoryжȡҪıӵshadering binding
+		// UserIndex һinstanced section ĵһtransform slot
+		const uint32 index = BatchElement.UserIndex;
 		ShaderBindings.Add(TransformIndex, index);
 		FDeformMeshSceneProxy* deformProxy = deformMeshVertexFactory->SceneProxy;
 		ShaderBindings.Add(TransformSRV, deformProxy->GetDeformTransformsSRV());
+		// ǰslice ͨuniform buffer , cached draw command õͬһuniform buffer
+		ShaderBindings.Add(Shader->GetUniformBufferParameter<FDeformMeshVFUniformParameters>(),
+			deformProxy->GetDeformMeshUniformBuffer());
+
+		const FDeformMeshBatchUserData* userData = static_cast<const FDeformMeshBatchUserData*>(BatchElement.UserData);
+
+		// r.DeformMesh.PreDeform ʱֻ⼸, λcompute pass Ѿdeform 
+		if (PreDeformedPositions.IsBound())
+		{
+			ShaderBindings.Add(PreDeformedPositions, deformProxy->GetPreDeformedPositionsSRV());
+			ShaderBindings.Add(PreDeformedBase, userData->PreDeformedBase);
+			ShaderBindings.Add(PreDeformedNumVertices, BatchElement.MaxVertexIndex + 1);
+		}
+
+		// ֻзRigid deformer vertex factory 
+		if (DeformerParams.IsBound())
+		{
+			ShaderBindings.Add(DeformerParams, deformProxy->GetDeformerParamsSRV());
+			ShaderBindings.Add(DeformerParamBase, userData->DeformerParamBase);
+		}
+	}
+
+private:
+	/**
+	 *
+	 */
+	LAYOUT_FIELD(FShaderParameter, TransformIndex);
+	LAYOUT_FIELD(FShaderResourceParameter, TransformSRV);
+	LAYOUT_FIELD(FShaderResourceParameter, PreDeformedPositions);
+	LAYOUT_FIELD(FShaderParameter, PreDeformedBase);
+	LAYOUT_FIELD(FShaderParameter, PreDeformedNumVertices);
+	LAYOUT_FIELD(FShaderResourceParameter, DeformerParams);
+	LAYOUT_FIELD(FShaderParameter, DeformerParamBase);
+};
+
+IMPLEMENT_TYPE_LAYOUT(FDeformMeshVertexFactoryShaderParameters);
+
+IMPLEMENT_VERTEX_FACTORY_PARAMETER_TYPE(FDeformMeshVertexFactory, SF_Vertex,
+	FDeformMeshVertexFactoryShaderParameters);
+
+// ڶ: ֧cache mesh draw command, shader binding ֻproxy ĳԴ
+// һ: primitive id stream, primitive uniform buffer mesh batch element 
+IMPLEMENT_VERTEX_FACTORY_TYPE_EX(FDeformMeshVertexFactory,
+	"/Plugin/CustomShaderModule/Private/LocalVertexFactory.ush", true, true, true, true, true, true, false);
+
+// ÿַRigid deformer һvertex factory type, FDeformMeshVertexFactory ʹͬһshader ļ
+IMPLEMENT_VERTEX_FACTORY_PARAMETER_TYPE(FDeformMeshBendVertexFactory, SF_Vertex,
+	FDeformMeshVertexFactoryShaderParameters);
+IMPLEMENT_VERTEX_FACTORY_TYPE_EX(FDeformMeshBendVertexFactory,
+	"/Plugin/CustomShaderModule/Private/LocalVertexFactory.ush", true, true, true, true, true, true, false);
+
+IMPLEMENT_VERTEX_FACTORY_PARAMETER_TYPE(FDeformMeshTwistVertexFactory, SF_Vertex,
+	FDeformMeshVertexFactoryShaderParameters);
+IMPLEMENT_VERTEX_FACTORY_TYPE_EX(FDeformMeshTwistVertexFactory,
+	"/Plugin/CustomShaderModule/Private/LocalVertexFactory.ush", true, true, true, true, true, true, false);
+
+IMPLEMENT_VERTEX_FACTORY_PARAMETER_TYPE(FDeformMeshTaperVertexFactory, SF_Vertex,
+	FDeformMeshVertexFactoryShaderParameters);
+IMPLEMENT_VERTEX_FACTORY_TYPE_EX(FDeformMeshTaperVertexFactory,
+	"/Plugin/CustomShaderModule/Private/LocalVertexFactory.ush", true, true, true, true, true, true, false);
+
+IMPLEMENT_VERTEX_FACTORY_PARAMETER_TYPE(FDeformMeshLatticeVertexFactory, SF_Vertex,
+	FDeformMeshVertexFactoryShaderParameters);
+IMPLEMENT_VERTEX_FACTORY_TYPE_EX(FDeformMeshLatticeVertexFactory,
+	"/Plugin/CustomShaderModule/Private/LocalVertexFactory.ush", true, true, true, true, true, true, false);
+
+// ÿ߳һ, render thread ÿview family Ⱦ֮ǰdrain һ
+// ̵ͬ߳ļ¼֮û˳, section Transform Visibility ¼ֻgame thread push
+static TDeformMeshMpscQueue<FDeformMeshUpdateRecord> GDeformMeshUpdateQueue;
+
+// һdrain Upload ¼proxy, ֻrender thread ʹ
+static TArray<FDeformMeshSceneProxy*> GDeformMeshUploadProxies;
+
+// һdrain ֮game thread push ļ¼
+static int32 GNumDeformMeshUpdatesSinceDrainRequest = 0;
+
+void DrainDeformMeshUpdateQueue_RenderThread()
+{
+	check(IsInRenderingThread());
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshDrainUpdateQueue);
+
+	const int32 numDrained = GDeformMeshUpdateQueue.Drain(&ApplyDeformMeshUpdateRecord_RenderThread);
+
+	// ߳push transform һUpload , ждϴ
+	for (FDeformMeshSceneProxy* deformProxy : GDeformMeshUploadProxies)
+	{
+		deformProxy->UpdateDeformTransformSB_RenderThread();
+	}
+	GDeformMeshUploadProxies.Reset();
+
+	// һ֡ӻɾsection proxy, ÿֻһ
+	for (FDeformMeshSceneProxy* deformProxy : GDeformMeshSlotsChangedProxies)
+	{
+		deformProxy->OnSlotsChanged_RenderThread();
+	}
+	GDeformMeshSlotsChangedProxies.Reset();
+
+	// proxy uniform buffer Ѿлµslice, proxy дһϴ,
+	// scene view extension, ûоGatherActiveExtensions view family (ͼ) Ҳܶ
+	GDeformMeshTransformPool.Flush(FRHICommandListExecutor::GetImmediateCommandList());
+
+	INC_DWORD_STAT_BY(STAT_DeformMeshUpdateRecords, numDrained);
+}
+
+double TimeDeformMeshSectionIteration_RenderThread(const FPrimitiveSceneProxy* Proxy, const FSceneView& View,
+	int32 NumIterations, int32& OutNumBatchElements)
+{
+	return static_cast<const FDeformMeshSceneProxy*>(Proxy)->TimeSectionIteration_RenderThread(View, NumIterations, OutNumBatchElements);
+}
+
+static void ApplyDeformMeshUpdateRecord_RenderThread(const FDeformMeshUpdateRecord& Record)
+{
+	switch (Record.Type)
+	{
+	case EDeformMeshUpdateType::Transform:
+	{
+		if (!Record.Proxy->IsUpdateForCurrentLayout_RenderThread(Record))
+		{
+			break;
+		}
+
+		FMatrix transformMatrix;
+		for (int32 row = 0; row < 3; row++)
+		{
+			transformMatrix.M[row][0] = Record.TransformRows[row].X;
+			transformMatrix.M[row][1] = Record.TransformRows[row].Y;
+			transformMatrix.M[row][2] = Record.TransformRows[row].Z;
+			transformMatrix.M[row][3] = Record.TransformRows[row].W;
+		}
+		transformMatrix.M[3][0] = transformMatrix.M[3][1] = transformMatrix.M[3][2] = 0.f;
+		transformMatrix.M[3][3] = 1.f;
+		Record.Proxy->UpateDeformTransofm_RenderThread(Record.SectionIndex, transformMatrix);
+		break;
+	}
+	case EDeformMeshUpdateType::Visibility:
+		if (Record.Proxy->IsUpdateForCurrentLayout_RenderThread(Record))
+		{
+			Record.Proxy->SetSectionVisibility_RenderThread(Record.SectionIndex, Record.bVisible);
+		}
+		break;
+	case EDeformMeshUpdateType::Upload:
+		if (Record.Proxy->RequestUpload_RenderThread())
+		{
+			GDeformMeshUploadProxies.Add(Record.Proxy);
+		}
+		break;
+	}
+}
+
+/**
+ * ̵߳, game thread ÿ r.DeformMesh.UpdateQueueDrainThreshold ¼ⷢһdrain render command
+ */
+static void PushDeformMeshUpdate(const FDeformMeshUpdateRecord& Record)
+{
+	GDeformMeshUpdateQueue.Push(Record);
+
+	if (IsInGameThread() &&
+		++GNumDeformMeshUpdatesSinceDrainRequest >= CVarDeformMeshUpdateQueueDrainThreshold.GetValueOnGameThread())
+	{
+		GNumDeformMeshUpdatesSinceDrainRequest = 0;
+		ENQUEUE_RENDER_COMMAND(FDeformMeshDrainUpdateQueue)(
+			[](FRHICommandListImmediate& RHICmdList)
+			{
+				DrainDeformMeshUpdateQueue_RenderThread();
+			});
+	}
+}
+
+static void PushDeformMeshTransformUpdate(FDeformMeshSceneProxy* Proxy, uint16 LayoutSerial, int32 SectionIndex,
+	const FMatrix& TransformMatrix)
+{
+	FDeformMeshUpdateRecord record;
+	record.Proxy = Proxy;
+	record.SectionIndex = SectionIndex;
+	record.Type = EDeformMeshUpdateType::Transform;
+	record.bVisible = true;
+	record.LayoutSerial = LayoutSerial;
+	for (int32 row = 0; row < 3; row++)
+	{
+		record.TransformRows[row] = FVector4(TransformMatrix.M[row][0], TransformMatrix.M[row][1],
+			TransformMatrix.M[row][2], TransformMatrix.M[row][3]);
+	}
+	PushDeformMeshUpdate(record);
+}
+
+static void PushDeformMeshUpdate(FDeformMeshSceneProxy* Proxy, EDeformMeshUpdateType Type, uint16 LayoutSerial = 0,
+	int32 SectionIndex = INDEX_NONE, bool bVisible = true)
+{
+	FDeformMeshUpdateRecord record;
+	record.Proxy = Proxy;
+	record.SectionIndex = SectionIndex;
+	record.Type = Type;
+	record.bVisible = bVisible;
+	record.LayoutSerial = LayoutSerial;
+	PushDeformMeshUpdate(record);
+}
+
+static void ValidateDeformMeshPreDeform()
+{
+	for (TObjectIterator<UDeformMeshComponent> it; it; ++it)
+	{
+		if (it->SceneProxy)
+		{
+			FDeformMeshSceneProxy* deformProxy = static_cast<FDeformMeshSceneProxy*>(it->SceneProxy);
+			ENQUEUE_RENDER_COMMAND(FDeformMeshValidatePreDeform)(
+				[deformProxy](FRHICommandListImmediate& RHICmdList)
+				{
+					deformProxy->ValidatePreDeform_RenderThread(RHICmdList);
+				});
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdDeformMeshValidatePreDeform(
+	TEXT("r.DeformMesh.ValidatePreDeform"),
+	TEXT("Reads back the pre deformed positions of every deform mesh component and logs the max difference\n")
+	TEXT("to the CPU reference. Stalls the GPU, debug only."),
+	FConsoleCommandDelegate::CreateStatic(&ValidateDeformMeshPreDeform));
+
+/**
+ * ÿdeform mesh component ڴ, game thread ĲGetResourceSizeEx, proxy Ĳrender thread ȡ
+ */
+static void DumpDeformMeshMemory()
+{
+	struct FComponentMemory
+	{
+		FString Name;
+		int32 NumSections;
+		SIZE_T GameThreadBytes;
+		const FDeformMeshSceneProxy* Proxy;
+	};
+
+	TArray<FComponentMemory> components;
+	for (TObjectIterator<UDeformMeshComponent> it; it; ++it)
+	{
+		FResourceSizeEx resourceSize(EResourceSizeMode::Exclusive);
+		it->GetResourceSizeEx(resourceSize);
+
+		FComponentMemory& component = components.AddDefaulted_GetRef();
+		component.Name = it->GetPathName();
+		component.NumSections = it->GetNumMaterials();
+		component.GameThreadBytes = resourceSize.GetDedicatedSystemMemoryBytes();
+		component.Proxy = static_cast<const FDeformMeshSceneProxy*>(it->SceneProxy);
+	}
+
+	ENQUEUE_RENDER_COMMAND(FDeformMeshDumpMemory)(
+		[components = MoveTemp(components)](FRHICommandListImmediate& RHICmdList)
+		{
+			SIZE_T totalGameThread = 0;
+			SIZE_T totalProxyCPU = 0;
+			SIZE_T totalProxyGPU = 0;
+			UE_LOG(LogDeformMesh, Log, TEXT("%10s %10s %10s %10s  %s"), TEXT("Sections"), TEXT("GT KB"), TEXT("Proxy KB"), TEXT("GPU KB"), TEXT("Component"));
+			for (const FComponentMemory& component : components)
+			{
+				const SIZE_T proxyCPU = component.Proxy ? component.Proxy->GetMemoryFootprint() : 0;
+				const SIZE_T proxyGPU = component.Proxy ? component.Proxy->GetGPUAllocatedSize() : 0;
+				UE_LOG(LogDeformMesh, Log, TEXT("%10d %10.1f %10.1f %10.1f  %s"), component.NumSections,
+					component.GameThreadBytes / 1024.f, proxyCPU / 1024.f, proxyGPU / 1024.f, *component.Name);
+
+				totalGameThread += component.GameThreadBytes;
+				totalProxyCPU += proxyCPU;
+				totalProxyGPU += proxyGPU;
+			}
+			UE_LOG(LogDeformMesh, Log, TEXT("%d components, game thread %.1f KB, proxy CPU %.1f KB, proxy GPU %.1f KB"),
+				components.Num(), totalGameThread / 1024.f, totalProxyCPU / 1024.f, totalProxyGPU / 1024.f);
+		});
+}
+
+static FAutoConsoleCommand CmdDeformMeshDumpMemory(
+	TEXT("r.DeformMesh.DumpMemory"),
+	TEXT("Logs the game thread, proxy CPU and proxy GPU memory of every deform mesh component and their totals."),
+	FConsoleCommandDelegate::CreateStatic(&DumpDeformMeshMemory));
+
+static void InitOrUpdateResource(FRenderResource* Resource)
+{
+	if (!Resource->IsInitialized())
+	{
+		Resource->InitResource();
+	}
+	else
+	{
+		Resource->UpdateRHI();
+	}
+}
+
+static void InitVertexFactoryData(FDeformMeshVertexFactory* VertexFactory,
+	FStaticMeshVertexBuffers* VertexBuffer)
+{
+	ENQUEUE_RENDER_COMMAND(StaticMeshVertexBuffersLegacyInit)(
+		[VertexFactory, VertexBuffer](FRHICommandListImmediate& RHICommandList)
+		{
+			InitOrUpdateResource(&VertexBuffer->PositionVertexBuffer);
+			//InitOrUpdateResource(&RHICommandList)
+			InitOrUpdateResource(&VertexBuffer->StaticMeshVertexBuffer);
+
+			FLocalVertexFactory::FDataType Data;
+			//VertexBuffer->PositionVertexBuffer
+			VertexBuffer->PositionVertexBuffer.BindPositionVertexBuffer(VertexFactory, Data);
+			VertexBuffer->StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(VertexFactory, Data);
+			// default declaration tangent, ֻposition and normal only declaration õnormal
+			VertexBuffer->StaticMeshVertexBuffer.BindTangentVertexBuffer(VertexFactory, Data);
+			VertexFactory->SetData(Data);
+
+			InitOrUpdateResource(VertexFactory);
+		}
+		);
+}
+
+void UDeformMeshComponent::CreateSection(int32 SectionIndex, 
+	UStaticMesh* SourceMesh, const FTransform& DeformTransform)
+{
+	LLM_SCOPE_DEFORM_MESH();
+
+	if (SectionIndex >= DeformMeshSections.Num())
+	{
+		DeformMeshSections.SetNum(SectionIndex + 1, false);
+	}
+	
+	FDeformMeshSection& newSection = DeformMeshSections[SectionIndex];
+	newSection.Reset();
+
+	newSection.StaticMesh = SourceMesh;
+	newSection.DeformTransform = DeformTransform.ToMatrixWithScale().GetTransposed(); //#Unkown 
+
+	newSection.StaticMesh->CalculateExtendedBounds();
+	newSection.DeformedMeshBox = newSection.StaticMesh->GetBoundingBox();
+	newSection.SectionBoundingBox = newSection.DeformedMeshBox.TransformBy(DeformTransform);
+
+	// bounds
+	UpdateSectionBounds(SectionIndex);
+	UpdateLocalBounds();
+
+	if (CanChangeSectionsInPlace(true) && SourceMesh->RenderData != nullptr)
+	{
+		// SetMaterial MarkRenderStateDirty, ֱoverride material
+		if (OverrideMaterials.Num() <= SectionIndex)
+		{
+			OverrideMaterials.SetNumZeroed(SectionIndex + 1);
+		}
+		OverrideMaterials[SectionIndex] = newSection.StaticMesh->GetMaterial(0);
+		MarkCachedMaterialParameterNameIndicesDirty();
+		SectionLayoutVersion++;
+		InPlaceSectionSerial++;
+
+		// CreateProxyBuildData һ, ʺrender data ֻgame thread ȡ
+		FDeformMeshAddSectionData addData;
+		addData.SectionIndex = SectionIndex;
+		addData.StaticMesh = SourceMesh;
+		addData.RenderData = SourceMesh->RenderData.Get();
+		addData.Material = GetMaterial(SectionIndex);
+		if (addData.Material == nullptr)
+		{
+			addData.Material = UMaterial::GetDefaultMaterial(MD_Surface);
+		}
+		addData.DeformTransform = newSection.DeformTransform;
+		addData.MaterialRelevance = GetMaterialRelevance(GetScene()->GetFeatureLevel());
+#if WITH_EDITOR
+		GetUsedMaterials(addData.UsedMaterials);
+#endif
+
+		FDeformMeshSceneProxy* deformMeshSceneProxy = static_cast<FDeformMeshSceneProxy*>(SceneProxy);
+		const uint16 layoutSerial = InPlaceSectionSerial;
+		ENQUEUE_RENDER_COMMAND(FDeformMeshAddSection)(
+			[deformMeshSceneProxy, addData, layoutSerial](FRHICommandListImmediate& RHICmdList)
+			{
+				deformMeshSceneProxy->AddSection_RenderThread(addData, layoutSerial);
+			});
+		return;
+	}
+
+	SetMaterial(SectionIndex, newSection.StaticMesh->GetMaterial(0));
+
+	// section 仯, Ҫؽproxy (ͬʱcache mesh draw commands)
+	SectionLayoutVersion++;
+	MarkRenderStateDirty();
+
+}
+
+int32 UDeformMeshComponent::AddSection(UStaticMesh* SourceMesh, const FTransform& DeformTransform)
+{
+	// section Ѿȥ, ߱CreateSection ֱʹ
+	int32 sectionIndex = INDEX_NONE;
+	while (FreeSectionIndices.Num() > 0)
+	{
+		const int32 freeIndex = FreeSectionIndices.Pop(false);
+		if (DeformMeshSections.IsValidIndex(freeIndex) && DeformMeshSections[freeIndex].StaticMesh == nullptr)
+		{
+			sectionIndex = freeIndex;
+			break;
+		}
+	}
+	if (sectionIndex == INDEX_NONE)
+	{
+		sectionIndex = DeformMeshSections.Num();
+	}
+
+	CreateSection(sectionIndex, SourceMesh, DeformTransform);
+	return sectionIndex;
+}
+
+void UDeformMeshComponent::CompactSections()
+{
+	TrimTrailingSections();
+	DeformMeshSections.Shrink();
+	OverrideMaterials.Shrink();
+	// ȥѾЧindex
+	RebuildFreeSectionIndices();
+	FreeSectionIndices.Shrink();
+	RebuildSectionBoundsTree();
+
+	// section index , ֻƶproxy transform slot
+	if (SceneProxy && !IsRenderStateDirty())
+	{
+		FDeformMeshSceneProxy* deformMeshSceneProxy = static_cast<FDeformMeshSceneProxy*>(SceneProxy);
+		ENQUEUE_RENDER_COMMAND(FDeformMeshCompactSlots)(
+			[deformMeshSceneProxy](FRHICommandListImmediate& RHICmdList)
+			{
+				deformMeshSceneProxy->CompactSlotsNow_RenderThread();
+			});
 	}
+}
 
-private:
-	/**
-	 *
-	 */
-	LAYOUT_FIELD(FShaderParameter, TransformIndex);
-	LAYOUT_FIELD(FShaderResourceParameter, TransformSRV);
-};
-
-IMPLEMENT_TYPE_LAYOUT(FDeformMeshVertexFactoryShaderParameters);
+void UDeformMeshComponent::RebuildFreeSectionIndices()
+{
+	// Ӻǰ, AddSection ĩβȡ, ȸСindex
+	FreeSectionIndices.Reset();
+	for (int32 sectionIndex = DeformMeshSections.Num() - 1; sectionIndex >= 0; sectionIndex--)
+	{
+		if (DeformMeshSections[sectionIndex].StaticMesh == nullptr)
+		{
+			FreeSectionIndices.Add(sectionIndex);
+		}
+	}
+}
 
-IMPLEMENT_VERTEX_FACTORY_PARAMETER_TYPE(FDeformMeshVertexFactory, SF_Vertex,
-	FDeformMeshVertexFactoryShaderParameters);
+void UDeformMeshComponent::PostLoad()
+{
+	Super::PostLoad();
 
-IMPLEMENT_VERTEX_FACTORY_TYPE(FDeformMeshVertexFactory,
-	"/Plugin/CustomShaderModule/Private/LocalVertexFactory.ush", true, true, true, true, true);
+	// FreeSectionIndices л, صsection ؽ
+	RebuildFreeSectionIndices();
+}
 
-static void InitOrUpdateResource(FRenderResource* Resource)
+void UDeformMeshComponent::TrimTrailingSections()
 {
-	if (!Resource->IsInitialized())
+	while (DeformMeshSections.Num() > 0 && DeformMeshSections.Last().StaticMesh == nullptr)
 	{
-		Resource->InitResource();
+		DeformMeshSections.Pop(false);
 	}
-	else
+	if (OverrideMaterials.Num() > DeformMeshSections.Num())
 	{
-		Resource->UpdateRHI();
+		OverrideMaterials.SetNum(DeformMeshSections.Num(), false);
 	}
 }
 
-static void InitVertexFactoryData(FDeformMeshVertexFactory* VertexFactory,
-	FStaticMeshVertexBuffers* VertexBuffer)
+bool UDeformMeshComponent::CanChangeSectionsInPlace(bool bAddingSection) const
 {
-	ENQUEUE_RENDER_COMMAND(StaticMeshVertexBuffersLegacyInit)(
-		[VertexFactory, VertexBuffer](FRHICommandListImmediate& RHICommandList)
-		{
-			InitOrUpdateResource(&VertexBuffer->PositionVertexBuffer);
-			//InitOrUpdateResource(&RHICommandList)
-			InitOrUpdateResource(&VertexBuffer->StaticMeshVertexBuffer);
-
-			FLocalVertexFactory::FDataType Data;
-			//VertexBuffer->PositionVertexBuffer
-			VertexBuffer->PositionVertexBuffer.BindPositionVertexBuffer(VertexFactory, Data);
-			VertexBuffer->StaticMeshVertexBuffer.BindPackedTexCoordVertexBuffer(VertexFactory, Data);
-			VertexFactory->SetData(Data);
+	// ûproxy, proxy Ҫؽ (̨build ) ʱֻsection 
+	if (SceneProxy == nullptr || IsRenderStateDirty() || ProxyBuildTask.IsValid() ||
+		CVarDeformMeshInPlaceSectionChanges.GetValueOnGameThread() == 0)
+	{
+		return false;
+	}
 
-			InitOrUpdateResource(VertexFactory);
-		}
-		);
+	// pre deform buffer proxy ʱsection 
+	return !bAddingSection || !IsDeformMeshPreDeformEnabled(GetScene()->GetShaderPlatform());
 }
 
-void UDeformMeshComponent::CreateSection(int32 SectionIndex, 
-	UStaticMesh* SourceMesh, const FTransform& DeformTransform)
+bool UDeformMeshComponent::SetSectionDeformTransform(int32 SectionIndex, const FTransform& DeformTransform,
+	FMatrix& OutTransformMatrix)
 {
-	if (SectionIndex >= DeformMeshSections.Num())
+	if (!DeformMeshSections.IsValidIndex(SectionIndex) ||
+		DeformMeshSections[SectionIndex].StaticMesh == nullptr)
 	{
-		DeformMeshSections.SetNum(SectionIndex + 1, false);
+		return false;
 	}
-	
-	FDeformMeshSection& newSection = DeformMeshSections[SectionIndex];
-	newSection.Reset();
 
-	newSection.StaticMesh = SourceMesh;
-	newSection.DeformTransform = DeformTransform.ToMatrixWithScale().GetTransposed(); //#Unkown 
+	FDeformMeshSection& section = DeformMeshSections[SectionIndex];
+	OutTransformMatrix = DeformTransform.ToMatrixWithScale().GetTransposed();
+	section.DeformTransform = OutTransformMatrix;
+	// ̨build ĿǾɵtransform
+	bProxyBuildTransformsStale = true;
+
+	// ÿζdeformer κbounds ¼, ܺ;ɵbounds ϲ, ֻԽԽ
+	const FBox localBox = section.DeformedMeshBox.IsValid ? section.DeformedMeshBox : section.StaticMesh->GetBoundingBox();
+	section.SectionBoundingBox = localBox.TransformBy(DeformTransform);
+	UpdateSectionBounds(SectionIndex);
+	return true;
+}
 
-	newSection.StaticMesh->CalculateExtendedBounds();
-	newSection.SectionBoundingBox += newSection.StaticMesh->GetBoundingBox();
+void UDeformMeshComponent::SetSectionDeformer(int32 SectionIndex, const FDeformMeshDeformer& Deformer)
+{
+	if (!DeformMeshSections.IsValidIndex(SectionIndex) ||
+		DeformMeshSections[SectionIndex].StaticMesh == nullptr)
+	{
+		return;
+	}
 
-	SetMaterial(SectionIndex, newSection.StaticMesh->GetMaterial(0));
+	FDeformMeshSection& section = DeformMeshSections[SectionIndex];
+	section.Deformer = Deformer;
+	section.DeformedMeshBox = CalcDeformMeshDeformerBounds(Deformer, section.StaticMesh->GetBoundingBox());
+	// DeformTransform תùľ
+	section.SectionBoundingBox = section.DeformedMeshBox.TransformBy(section.DeformTransform.GetTransposed());
 
-	// bounds
+	UpdateSectionBounds(SectionIndex);
 	UpdateLocalBounds();
 
-	// Need to send to render thread
-	MarkRenderTransformDirty();
-
+	// deformer vertex factory, ڴproxy ʱ, Ҫؽproxy
+	SectionLayoutVersion++;
+	MarkRenderStateDirty();
 }
 
 void UDeformMeshComponent::UpdateSectionTransform(int32 SectionIndex, const FTransform& DeformTransform)
 {
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshUpdateSectionTransform);
 
-	if (SectionIndex < DeformMeshSections.Num())
+	FMatrix transformMatrix;
+	if (SetSectionDeformTransform(SectionIndex, DeformTransform, transformMatrix))
 	{
-		const FMatrix transformMatrix = DeformTransform.ToMatrixWithScale().GetTransposed();
-		DeformMeshSections[SectionIndex].DeformTransform = transformMatrix;
+		if (SceneProxy)
+		{
+			PushDeformMeshTransformUpdate(static_cast<FDeformMeshSceneProxy*>(SceneProxy), InPlaceSectionSerial, SectionIndex,
+				transformMatrix);
+		}
 
-		DeformMeshSections[SectionIndex].SectionBoundingBox += 
-			DeformMeshSections[SectionIndex].StaticMesh->GetBoundingBox().TransformBy(DeformTransform);
+		// UpdateLocalBounds Ѿ MarkRenderTransformDirty
+		UpdateLocalBounds();
+	}
+}
 
-		if (SceneProxy)
+void UDeformMeshComponent::UpdateSectionTransforms(TArrayView<const int32> SectionIndices,
+	TArrayView<const FTransform> DeformTransforms)
+{
+	check(SectionIndices.Num() == DeformTransforms.Num());
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshUpdateSectionTransforms);
+
+	FDeformMeshSceneProxy* deformMeshSceneProxy = static_cast<FDeformMeshSceneProxy*>(SceneProxy);
+	bool bAnyUpdated = false;
+	for (int32 i = 0; i < SectionIndices.Num(); i++)
+	{
+		FMatrix transformMatrix;
+		if (SetSectionDeformTransform(SectionIndices[i], DeformTransforms[i], transformMatrix))
+		{
+			bAnyUpdated = true;
+			if (deformMeshSceneProxy)
+			{
+				PushDeformMeshTransformUpdate(deformMeshSceneProxy, InPlaceSectionSerial, SectionIndices[i], transformMatrix);
+			}
+		}
+	}
+
+	// ֻһbounds
+	if (bAnyUpdated)
+	{
+		UpdateLocalBounds();
+	}
+}
+
+void UDeformMeshComponent::K2_UpdateSectionTransforms(const TArray<int32>& SectionIndices,
+	const TArray<FTransform>& DeformTransforms)
+{
+	if (ensureMsgf(SectionIndices.Num() == DeformTransforms.Num(),
+		TEXT("UpdateSectionTransforms: %d section indices but %d transforms"),
+		SectionIndices.Num(), DeformTransforms.Num()))
+	{
+		UpdateSectionTransforms(SectionIndices, DeformTransforms);
+	}
+}
+
+void UDeformMeshComponent::UpdateSectionTransformsBatched(TArrayView<UDeformMeshComponent* const> Components,
+	TArrayView<const int32> SectionIndices, TArrayView<const FTransform> DeformTransforms)
+{
+	check(Components.Num() == SectionIndices.Num() && Components.Num() == DeformTransforms.Num());
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshUpdateSectionTransformsBatched);
+
+	const int32 num = Components.Num();
+
+#pragma region GroupByComponent
+	// ͬһcomponent Ŀ, ͬһtask ˳, section bounds tree ᱻ߳ͬʱ޸
+	TArray<int32> componentFirstEntries;
+	TArray<int32> nextEntries;
+	nextEntries.Init(INDEX_NONE, num);
+	{
+		TMap<UDeformMeshComponent*, int32> lastEntries;
+		lastEntries.Reserve(num);
+		for (int32 i = 0; i < num; i++)
+		{
+			if (int32* lastEntry = lastEntries.Find(Components[i]))
+			{
+				nextEntries[*lastEntry] = i;
+				*lastEntry = i;
+			}
+			else
+			{
+				lastEntries.Add(Components[i], i);
+				componentFirstEntries.Add(i);
+			}
+		}
+	}
+	const int32 numComponents = componentFirstEntries.Num();
+#pragma endregion
+
+#pragma region SetSectionDataAndBounds
+	// ̵ͬ߳Ķ֮û˳, transform ¼֮game thread push, UpdateSectionTransform ļ¼ֵ˳
+	TArray<uint8> updated;
+	updated.SetNumZeroed(num);
+	TArray<FMatrix> transformMatrices;
+	transformMatrices.SetNumUninitialized(num);
+	TArray<uint8> componentsUpdated;
+	componentsUpdated.SetNumZeroed(numComponents);
+
+	const int32 chunkSize = 256;
+	const int32 numChunks = FMath::DivideAndRoundUp(numComponents, chunkSize);
+	ParallelFor(numChunks, [&](int32 ChunkIndex)
 		{
-			FDeformMeshSceneProxy* deformMeshSceneProxy = (FDeformMeshSceneProxy*)SceneProxy;
-			
-			ENQUEUE_RENDER_COMMAND(FDeformTransformUpdate)(
-				[deformMeshSceneProxy, SectionIndex, transformMatrix](FRHICommandListImmediate& RHICmdList)
+			const int32 chunkEnd = FMath::Min((ChunkIndex + 1) * chunkSize, numComponents);
+			for (int32 componentIndex = ChunkIndex * chunkSize; componentIndex < chunkEnd; componentIndex++)
+			{
+				UDeformMeshComponent* deformCom = Components[componentFirstEntries[componentIndex]];
+				for (int32 i = componentFirstEntries[componentIndex]; i != INDEX_NONE; i = nextEntries[i])
 				{
-					deformMeshSceneProxy->UpateDeformTransofm_RenderThread(SectionIndex, transformMatrix);
+					updated[i] = deformCom->SetSectionDeformTransform(SectionIndices[i], DeformTransforms[i], transformMatrices[i]);
+					componentsUpdated[componentIndex] |= updated[i];
 				}
-			);
+
+				// ÿcomponent ֻһbounds
+				if (componentsUpdated[componentIndex])
+				{
+					deformCom->UpdateLocalBoundsConcurrent();
+				}
+			}
+		}, numChunks <= 1);
+#pragma endregion
+
+#pragma region PushRecords
+	// ¼˳push, section world bounds transform ¼proxy
+	for (int32 i = 0; i < num; i++)
+	{
+		if (updated[i] && Components[i]->SceneProxy)
+		{
+			PushDeformMeshTransformUpdate(static_cast<FDeformMeshSceneProxy*>(Components[i]->SceneProxy),
+				Components[i]->InPlaceSectionSerial, SectionIndices[i], transformMatrices[i]);
 		}
+	}
 
-		UpdateLocalBounds();
-		MarkRenderTransformDirty();
+	// scene еbounds ֻڱòʱ, component һ֡UpdatePrimitiveTransform render command
+	for (int32 componentIndex = 0; componentIndex < numComponents; componentIndex++)
+	{
+		if (!componentsUpdated[componentIndex])
+		{
+			continue;
+		}
+
+		UDeformMeshComponent* deformCom = Components[componentFirstEntries[componentIndex]];
+		if (deformCom->NeedsSceneBoundsUpdate())
+		{
+			deformCom->MarkRenderTransformDirty();
+		}
+		if (deformCom->SceneProxy)
+		{
+			PushDeformMeshUpdate(static_cast<FDeformMeshSceneProxy*>(deformCom->SceneProxy), EDeformMeshUpdateType::Upload);
+		}
 	}
+#pragma endregion
 }
 
 /// <summary>
@@ -661,30 +3453,57 @@ void UDeformMeshComponent::FinishDeformUpdate()
 {
 	if (SceneProxy)
 	{
-		FDeformMeshSceneProxy* deformMeshSceneProxy = static_cast<FDeformMeshSceneProxy*>(SceneProxy);
-		ENQUEUE_RENDER_COMMAND(FDeformMeshAllTransformSBUpdate)(
-			[deformMeshSceneProxy](FRHICommandListImmediate& RHICmdList)
-			{
-				deformMeshSceneProxy->UpdateDeformTransformSB_RenderThread();
-			});
+		PushDeformMeshUpdate(static_cast<FDeformMeshSceneProxy*>(SceneProxy), EDeformMeshUpdateType::Upload);
 	}
 }
 
 void UDeformMeshComponent::ClearSection(int32 SectionIndex)
 {
-	if (SectionIndex < DeformMeshSections.Num())
+	// Ѿǿյsection ɾ, װϺ̨build proxy ؽƶslot
+	if (!DeformMeshSections.IsValidIndex(SectionIndex) || DeformMeshSections[SectionIndex].StaticMesh == nullptr)
 	{
-		DeformMeshSections[SectionIndex].Reset();
-		UpdateLocalBounds();
-		MarkRenderTransformDirty();
+		return;
+	}
+
+	FreeSectionIndices.Add(SectionIndex);
+	DeformMeshSections[SectionIndex].Reset();
+	UpdateSectionBounds(SectionIndex);
+
+	// section ò, ĩβĿsection ֱȥ, мAddSection 
+	if (OverrideMaterials.IsValidIndex(SectionIndex))
+	{
+		OverrideMaterials[SectionIndex] = nullptr;
+	}
+	TrimTrailingSections();
+
+	UpdateLocalBounds();
+	SectionLayoutVersion++;
+
+	if (CanChangeSectionsInPlace(false))
+	{
+		InPlaceSectionSerial++;
+		FDeformMeshSceneProxy* deformMeshSceneProxy = static_cast<FDeformMeshSceneProxy*>(SceneProxy);
+		const uint16 layoutSerial = InPlaceSectionSerial;
+		ENQUEUE_RENDER_COMMAND(FDeformMeshRemoveSection)(
+			[deformMeshSceneProxy, SectionIndex, layoutSerial](FRHICommandListImmediate& RHICmdList)
+			{
+				deformMeshSceneProxy->RemoveSection_RenderThread(SectionIndex, layoutSerial);
+			});
+	}
+	else
+	{
+		MarkRenderStateDirty();
 	}
 }
 
 void UDeformMeshComponent::ClearAllMeshSections()
 {
 	DeformMeshSections.Empty();
+	FreeSectionIndices.Empty();
+	SectionBoundsTree.Reset(0);
 	UpdateLocalBounds();
-	MarkRenderTransformDirty();
+	SectionLayoutVersion++;
+	MarkRenderStateDirty();
 }
 
 int32 UDeformMeshComponent::GetNumMaterials() const
@@ -692,6 +3511,29 @@ int32 UDeformMeshComponent::GetNumMaterials() const
 	return DeformMeshSections.Num();
 }
 
+void UDeformMeshComponent::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+	Super::GetResourceSizeEx(CumulativeResourceSize);
+
+	// static mesh ǵasset, 
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(DeformMeshSections.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(SectionBoundsTree.GetAllocatedSize());
+	CumulativeResourceSize.AddDedicatedSystemMemoryBytes(FreeSectionIndices.GetAllocatedSize());
+	for (const FDeformMeshSection& section : DeformMeshSections)
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(section.Deformer.LatticeOffsets.GetAllocatedSize());
+	}
+	if (ProxyBuildData.IsValid())
+	{
+		CumulativeResourceSize.AddDedicatedSystemMemoryBytes(sizeof(FDeformMeshProxyBuildData) + ProxyBuildData->Snapshot.GetAllocatedSize());
+	}
+}
+
+FBox UDeformMeshComponent::GetSectionBoundingBox(int32 SectionIndex) const
+{
+	return DeformMeshSections.IsValidIndex(SectionIndex) ? DeformMeshSections[SectionIndex].SectionBoundingBox : FBox(ForceInit);
+}
+
 FBoxSphereBounds UDeformMeshComponent::CalcBounds(const FTransform& LocalToWorld) const
 {
 	FBoxSphereBounds ret(LocalBounds.TransformBy(LocalToWorld));
@@ -704,48 +3546,253 @@ FBoxSphereBounds UDeformMeshComponent::CalcBounds(const FTransform& LocalToWorld
 FPrimitiveSceneProxy* UDeformMeshComponent::CreateSceneProxy()
 {
 	//Super::CreateSceneProxy();
-	if (!SceneProxy)
+	if (SceneProxy)
 	{
-		return new FDeformMeshSceneProxy(this);
+		return SceneProxy;
 	}
-	else
+
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshCreateSceneProxy);
+	LLM_SCOPE_DEFORM_MESH();
+
+#pragma region FinishAsyncProxyBuild
+	if (ProxyBuildTask.IsValid())
 	{
-		return SceneProxy;
+		// build, ʱٴMarkRenderStateDirty, ֮ǰ
+		if (!ProxyBuildTask->IsComplete())
+		{
+			return nullptr;
+		}
+
+		TSharedPtr<FDeformMeshProxyBuildData, ESPMode::ThreadSafe> buildData = MoveTemp(ProxyBuildData);
+		ProxyBuildTask = nullptr;
+
+		// build ڼsection , ɾmesh//deformer, , ڵsection build
+		if (buildData->LayoutVersion == SectionLayoutVersion)
+		{
+			buildData->bTransformsStale = bProxyBuildTransformsStale;
+			bProxyBuildTransformsStale = false;
+			return new FDeformMeshSceneProxy(this, *buildData);
+		}
+	}
+#pragma endregion
+
+	TSharedRef<FDeformMeshProxyBuildData, ESPMode::ThreadSafe> buildData = CreateProxyBuildData();
+
+	const int32 asyncMinSections = CVarDeformMeshAsyncProxyBuild.GetValueOnGameThread();
+	if (asyncMinSections <= 0 || DeformMeshSections.Num() < asyncMinSections)
+	{
+		BuildDeformMeshProxyData(*buildData);
+		return new FDeformMeshSceneProxy(this, *buildData);
+	}
+
+#pragma region StartAsyncProxyBuild
+	// task ֻbuildData, component ǰҲûйϵ
+	ProxyBuildData = buildData;
+	ProxyBuildTask = FFunctionGraphTask::CreateAndDispatchWhenReady(
+		[buildData]()
+		{
+			BuildDeformMeshProxyData(*buildData);
+		},
+		TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+
+	// ɺصgame thread ´render state, CreateSceneProxy build Ľ
+	const FGraphEventArray prerequisites = { ProxyBuildTask };
+	TWeakObjectPtr<UDeformMeshComponent> weakThis(this);
+	FFunctionGraphTask::CreateAndDispatchWhenReady(
+		[weakThis]()
+		{
+			if (UDeformMeshComponent* deformCom = weakThis.Get())
+			{
+				deformCom->MarkRenderStateDirty();
+			}
+		},
+		TStatId(), &prerequisites, ENamedThreads::GameThread);
+
+	INC_DWORD_STAT(STAT_DeformMeshAsyncProxyBuilds);
+	return nullptr;
+#pragma endregion
+}
+
+TSharedRef<FDeformMeshProxyBuildData, ESPMode::ThreadSafe> UDeformMeshComponent::CreateProxyBuildData()
+{
+	TSharedRef<FDeformMeshProxyBuildData, ESPMode::ThreadSafe> buildData = MakeShared<FDeformMeshProxyBuildData, ESPMode::ThreadSafe>();
+	buildData->LayoutVersion = SectionLayoutVersion;
+	bProxyBuildTransformsStale = false;
+
+	// ʺrender data ֻgame thread ȡ, Ķֵ
+	buildData->Snapshot.SetNum(DeformMeshSections.Num());
+	for (int32 sectionIndex = 0; sectionIndex < DeformMeshSections.Num(); sectionIndex++)
+	{
+		const FDeformMeshSection& srcSection = DeformMeshSections[sectionIndex];
+		FDeformMeshProxyBuildData::FSectionSnapshot& section = buildData->Snapshot[sectionIndex];
+
+		section.StaticMesh = srcSection.StaticMesh != nullptr && srcSection.StaticMesh->RenderData != nullptr ?
+			srcSection.StaticMesh : nullptr;
+		if (section.StaticMesh == nullptr)
+		{
+			continue;
+		}
+
+		section.Material = GetMaterial(sectionIndex);
+		if (section.Material == nullptr)
+		{
+			section.Material = UMaterial::GetDefaultMaterial(MD_Surface);
+		}
+
+		section.DeformerKind = srcSection.Deformer.Kind;
+		if (!IsDeformMeshDeformerEnabled(section.DeformerKind))
+		{
+			UE_LOG(LogDeformMesh, Warning, TEXT("%s: section %d uses a deformer kind not enabled in r.DeformMesh.Deformers, drawn rigid"),
+				*GetName(), sectionIndex);
+			section.DeformerKind = EDeformMeshDeformerKind::Rigid;
+		}
+
+		section.DeformTransform = srcSection.DeformTransform;
+		section.bVisible = srcSection.bSectionVisible;
+		section.DeformedMeshBox = srcSection.DeformedMeshBox;
+		if (section.DeformerKind != EDeformMeshDeformerKind::Rigid)
+		{
+			section.Deformer = srcSection.Deformer;
+		}
 	}
+
+	return buildData;
+}
+
+void UDeformMeshComponent::SetMaterial(int32 ElementIndex, UMaterialInterface* Material)
+{
+	// ʾsection ķ
+	SectionLayoutVersion++;
+	Super::SetMaterial(ElementIndex, Material);
 }
 
 void UDeformMeshComponent::SetMeshSectionVisible(int32 SectionIndex, bool bNewVisibility)
 {
-	if (SectionIndex < DeformMeshSections.Num())
+	if (DeformMeshSections.IsValidIndex(SectionIndex))
 	{
 		DeformMeshSections[SectionIndex].bSectionVisible = bNewVisibility;
+		bProxyBuildTransformsStale = true;
 
 		if (SceneProxy)
 		{
-			FDeformMeshSceneProxy* deformProxy = static_cast<FDeformMeshSceneProxy*>(SceneProxy);
-			ENQUEUE_RENDER_COMMAND(FDeformMeshVisibilityUpdate)(
-				[deformProxy, SectionIndex, bNewVisibility](FRHICommandListImmediate& RHICmdList)
-				{
-					deformProxy->SetSectionVisibility_RenderThread(SectionIndex, bNewVisibility);
-				});
+			PushDeformMeshUpdate(static_cast<FDeformMeshSceneProxy*>(SceneProxy), EDeformMeshUpdateType::Visibility,
+				InPlaceSectionSerial, SectionIndex, bNewVisibility);
 		}
 	}
 }
 
+void UDeformMeshComponent::DestroyRenderState_Concurrent()
+{
+	// пܻproxy ļ¼, proxy ɾ֮ǰ
+	if (SceneProxy)
+	{
+		ENQUEUE_RENDER_COMMAND(FDeformMeshDrainUpdateQueue)(
+			[](FRHICommandListImmediate& RHICmdList)
+			{
+				DrainDeformMeshUpdateQueue_RenderThread();
+			});
+	}
+	Super::DestroyRenderState_Concurrent();
+}
+
+void UDeformMeshComponent::SetLODBias(int32 NewLODBias)
+{
+	NewLODBias = FMath::Max(NewLODBias, 0);
+	if (LODBias != NewLODBias)
+	{
+		LODBias = NewLODBias;
+		// LODBias ڴproxy ʱȡ, cached mesh batch ҲҪؽ
+		MarkRenderStateDirty();
+	}
+}
+
+void FDeformMeshBoundsTree::Reset(int32 InNumLeaves)
+{
+	NumLeaves = (int32)FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(InNumLeaves, 1));
+	Nodes.Init(FBox(ForceInit), 2 * NumLeaves);
+}
+
+void FDeformMeshBoundsTree::Update(int32 Leaf, const FBox& Box)
+{
+	check(Leaf >= 0 && Leaf < NumLeaves);
+
+	int32 node = NumLeaves + Leaf;
+	Nodes[node] = Box;
+	for (node >>= 1; node >= 1; node >>= 1)
+	{
+		// Чbox ʱᱻ
+		Nodes[node] = Nodes[2 * node] + Nodes[2 * node + 1];
+	}
+}
+
+void UDeformMeshComponent::UpdateSectionBounds(int32 SectionIndex)
+{
+	if (SectionIndex >= SectionBoundsTree.GetNumLeaves())
+	{
+		RebuildSectionBoundsTree();
+	}
+	else
+	{
+		SectionBoundsTree.Update(SectionIndex, DeformMeshSections[SectionIndex].SectionBoundingBox);
+	}
+}
+
+void UDeformMeshComponent::RebuildSectionBoundsTree()
+{
+	SectionBoundsTree.Reset(DeformMeshSections.Num());
+	for (int32 sectionIndex = 0; sectionIndex < DeformMeshSections.Num(); sectionIndex++)
+	{
+		SectionBoundsTree.Update(sectionIndex, DeformMeshSections[sectionIndex].SectionBoundingBox);
+	}
+}
+
 void UDeformMeshComponent::UpdateLocalBounds()
 {
-	FBox localBox(ForceInit);
+	UpdateLocalBoundsConcurrent();
+	MarkRenderTransformDirty();
+}
+
+void UDeformMeshComponent::UpdateLocalBoundsConcurrent()
+{
+	SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshUpdateLocalBounds);
 
-	for (const FDeformMeshSection& deformSection: DeformMeshSections)
+	// ֮tree ǿյ
+	if (SectionBoundsTree.GetNumLeaves() < DeformMeshSections.Num())
 	{
-		localBox += deformSection.SectionBoundingBox;
+		RebuildSectionBoundsTree();
 	}
 
+	const FBox& localBox = SectionBoundsTree.GetRoot();
+
 	LocalBounds = localBox.IsValid ? FBoxSphereBounds(localBox) : 
 		FBoxSphereBounds(FVector(0, 0, 0), FVector(0, 0, 0), 0); // fall back reset
 
 	// Update Global Bounds
 	UpdateBounds();
+}
 
-	MarkRenderTransformDirty();
+bool UDeformMeshComponent::NeedsSceneBoundsUpdate() const
+{
+	const FBox box = Bounds.GetBox();
+	const FBox sceneBox = SceneBounds.GetBox();
+	if (!sceneBox.IsInsideOrOn(box.Min) || !sceneBox.IsInsideOrOn(box.Max))
+	{
+		return true;
+	}
+
+	// scene еbounds ̫ʱ޳Ч, 뾶СһҲ
+	return Bounds.SphereRadius < SceneBounds.SphereRadius * 0.5f;
+}
+
+void UDeformMeshComponent::CreateRenderState_Concurrent(FRegisterComponentContext* Context)
+{
+	Super::CreateRenderState_Concurrent(Context);
+	SceneBounds = Bounds;
+}
+
+void UDeformMeshComponent::SendRenderTransform_Concurrent()
+{
+	// Super UpdateBounds, ٰBounds scene
+	Super::SendRenderTransform_Concurrent();
+	SceneBounds = Bounds;
 }
@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DeformMeshDeformers.h"
+
+int32 GetDeformMeshDeformerParamStride(EDeformMeshDeformerKind Kind)
+{
+	switch (Kind)
+	{
+	case EDeformMeshDeformerKind::Bend:
+	case EDeformMeshDeformerKind::Twist:
+	case EDeformMeshDeformerKind::Taper:
+		return 1;
+	case EDeformMeshDeformerKind::Lattice:
+		// box min, 1 / size, 8 Ƶƫ
+		return 10;
+	default:
+		return 0;
+	}
+}
+
+void PackDeformMeshDeformerParams(const FDeformMeshDeformer& Deformer, TArray<FVector4>& OutParams)
+{
+	switch (Deformer.Kind)
+	{
+	case EDeformMeshDeformerKind::Bend:
+	case EDeformMeshDeformerKind::Twist:
+		OutParams.Add(FVector4(Deformer.Amount, Deformer.MinZ, Deformer.MaxZ, 0.f));
+		break;
+	case EDeformMeshDeformerKind::Taper:
+		OutParams.Add(FVector4(Deformer.MinZ, Deformer.MaxZ, Deformer.TaperStartScale, Deformer.TaperEndScale));
+		break;
+	case EDeformMeshDeformerKind::Lattice:
+	{
+		const FBox box = Deformer.LatticeBox.IsValid ? Deformer.LatticeBox : FBox(FVector(-50.f), FVector(50.f));
+		const FVector size = box.GetSize().ComponentMax(FVector(KINDA_SMALL_NUMBER));
+		OutParams.Add(FVector4(box.Min, 0.f));
+		OutParams.Add(FVector4(FVector(1.f) / size, 0.f));
+		for (int32 i = 0; i < 8; i++)
+		{
+			OutParams.Add(FVector4(Deformer.LatticeOffsets.IsValidIndex(i) ? Deformer.LatticeOffsets[i] : FVector::ZeroVector, 0.f));
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+FVector ApplyDeformMeshDeformer(EDeformMeshDeformerKind Kind, const FVector4* Params, const FVector& LocalPosition)
+{
+	const FVector& p = LocalPosition;
+	switch (Kind)
+	{
+	case EDeformMeshDeformerKind::Bend:
+	{
+		const float curvature = Params[0].X;
+		if (FMath::Abs(curvature) < 1e-6f)
+		{
+			return p;
+		}
+		const float z = FMath::Clamp(p.Z, Params[0].Y, Params[0].Z);
+		const float radius = 1.f / curvature;
+		float s, c;
+		FMath::SinCos(&s, &c, z * curvature);
+		// Χ֮ض˵߷
+		const float extra = p.Z - z;
+		return FVector(radius - (radius - p.X) * c + extra * s, p.Y, (radius - p.X) * s + extra * c);
+	}
+	case EDeformMeshDeformerKind::Twist:
+	{
+		float s, c;
+		FMath::SinCos(&s, &c, FMath::Clamp(p.Z, Params[0].Y, Params[0].Z) * Params[0].X);
+		return FVector(p.X * c - p.Y * s, p.X * s + p.Y * c, p.Z);
+	}
+	case EDeformMeshDeformerKind::Taper:
+	{
+		const float alpha = FMath::Clamp((p.Z - Params[0].X) / FMath::Max(Params[0].Y - Params[0].X, 1e-4f), 0.f, 1.f);
+		const float scale = FMath::Lerp(Params[0].Z, Params[0].W, alpha);
+		return FVector(p.X * scale, p.Y * scale, p.Z);
+	}
+	case EDeformMeshDeformerKind::Lattice:
+	{
+		const FVector t = ((p - FVector(Params[0])) * FVector(Params[1])).BoundToBox(FVector::ZeroVector, FVector::OneVector);
+		const FVector4* offsets = &Params[2];
+		const FVector o00 = FMath::Lerp(FVector(offsets[0]), FVector(offsets[1]), t.X);
+		const FVector o10 = FMath::Lerp(FVector(offsets[2]), FVector(offsets[3]), t.X);
+		const FVector o01 = FMath::Lerp(FVector(offsets[4]), FVector(offsets[5]), t.X);
+		const FVector o11 = FMath::Lerp(FVector(offsets[6]), FVector(offsets[7]), t.X);
+		return p + FMath::Lerp(FMath::Lerp(o00, o10, t.Y), FMath::Lerp(o01, o11, t.Y), t.Z);
+	}
+	default:
+		return p;
+	}
+}
+
+/**
+ * Bend x һ[AngleA, AngleB] ΧԲbounds, Բ(Radius, 0), 뾶Radius - X
+ * ˶˵, ֻнǶPI / 2 ʱX Z ȡֵ
+ */
+static void AddBendArcBounds(float Radius, float X, float AngleA, float AngleB, FBox2D& OutBox)
+{
+	const float arcRadius = Radius - X;
+	auto addAngle = [Radius, arcRadius, &OutBox](float Angle)
+	{
+		float s, c;
+		FMath::SinCos(&s, &c, Angle);
+		OutBox += FVector2D(Radius - arcRadius * c, arcRadius * s);
+	};
+
+	addAngle(AngleA);
+	addAngle(AngleB);
+	// һȦʱ4 򶼵
+	const int32 firstQuarter = FMath::CeilToInt(AngleA / HALF_PI);
+	const int32 lastQuarter = FMath::Min(FMath::FloorToInt(AngleB / HALF_PI), firstQuarter + 3);
+	for (int32 quarter = firstQuarter; quarter <= lastQuarter; quarter++)
+	{
+		addAngle(quarter * HALF_PI);
+	}
+}
+
+FBox CalcDeformMeshDeformerBounds(const FDeformMeshDeformer& Deformer, const FBox& LocalBox)
+{
+	if (Deformer.Kind == EDeformMeshDeformerKind::Rigid || !LocalBox.IsValid)
+	{
+		return LocalBox;
+	}
+
+	TArray<FVector4> params;
+	PackDeformMeshDeformerParams(Deformer, params);
+
+	// Taper Bend ΧĲֶbox ÿԻ˫Ե, ֵ8 
+	FBox result(ForceInit);
+	for (int32 corner = 0; corner < 8; corner++)
+	{
+		const FVector cornerPosition(
+			(corner & 1) ? LocalBox.Max.X : LocalBox.Min.X,
+			(corner & 2) ? LocalBox.Max.Y : LocalBox.Min.Y,
+			(corner & 4) ? LocalBox.Max.Z : LocalBox.Min.Z);
+		result += ApplyDeformMeshDeformer(Deformer.Kind, params.GetData(), cornerPosition);
+	}
+
+	switch (Deformer.Kind)
+	{
+	case EDeformMeshDeformerKind::Bend:
+	{
+		const float curvature = params[0].X;
+		if (FMath::Abs(curvature) < 1e-6f)
+		{
+			return LocalBox;
+		}
+
+		// box ڷΧʱֻߵ, 8 ǾǾȷ
+		const float minZ = FMath::Max(LocalBox.Min.Z, params[0].Y);
+		const float maxZ = FMath::Min(LocalBox.Max.Z, params[0].Z);
+		if (minZ > maxZ)
+		{
+			return result;
+		}
+
+		// ΧڵĲ: ÿx Բ, λöx Ե, ֻҪx ˵Բ
+		const float radius = 1.f / curvature;
+		const float angleA = minZ * curvature;
+		const float angleB = maxZ * curvature;
+		FBox2D arcBox(ForceInit);
+		AddBendArcBounds(radius, LocalBox.Min.X, FMath::Min(angleA, angleB), FMath::Max(angleA, angleB), arcBox);
+		AddBendArcBounds(radius, LocalBox.Max.X, FMath::Min(angleA, angleB), FMath::Max(angleA, angleB), arcBox);
+		result += FBox(FVector(arcBox.Min.X, LocalBox.Min.Y, arcBox.Min.Y), FVector(arcBox.Max.X, LocalBox.Max.Y, arcBox.Max.Y));
+		return result;
+	}
+	case EDeformMeshDeformerKind::Twist:
+	{
+		// Z ת, XY ڰ뾶Ϊbox ԶĽǵԲ
+		const float maxX = FMath::Max(FMath::Abs(LocalBox.Min.X), FMath::Abs(LocalBox.Max.X));
+		const float maxY = FMath::Max(FMath::Abs(LocalBox.Min.Y), FMath::Abs(LocalBox.Max.Y));
+		const float radius = FMath::Sqrt(maxX * maxX + maxY * maxY);
+		return FBox(FVector(-radius, -radius, LocalBox.Min.Z), FVector(radius, radius, LocalBox.Max.Z));
+	}
+	case EDeformMeshDeformerKind::Lattice:
+	{
+		// ƫ8 ƵƫƵ͹
+		FBox offsetBox(ForceInit);
+		for (int32 i = 0; i < 8; i++)
+		{
+			offsetBox += FVector(params[2 + i]);
+		}
+		return FBox(LocalBox.Min + offsetBox.Min, LocalBox.Max + offsetBox.Max);
+	}
+	default:
+		return result;
+	}
+}
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DeformMeshComponent.h"
+
+/** һdeformer DMDeformerParams ռfloat4, Rigid ûв */
+int32 GetDeformMeshDeformerParamStride(EDeformMeshDeformerKind Kind);
+
+/** DeformMeshCommon.ush ĲִDeformer Ĳ, OutParams GetDeformMeshDeformerParamStride float4 */
+void PackDeformMeshDeformerParams(const FDeformMeshDeformer& Deformer, TArray<FVector4>& OutParams);
+
+/**
+ * DeformMeshCommon.ush ApplyDeformMeshDeformer CPU 汾, Params ǴĲ
+ * ڼbounds ֤pre deform Ľ
+ */
+FVector ApplyDeformMeshDeformer(EDeformMeshDeformerKind Kind, const FVector4* Params, const FVector& LocalPosition);
+
+/**
+ * LocalBox еĵ㾭Deformer ֮bounds, , ʵʵС
+ * Bend Taper Ǿȷ, Twist ðסbox Բ, Lattice ÿƵƫƵķΧ
+ */
+FBox CalcDeformMeshDeformerBounds(const FDeformMeshDeformer& Deformer, const FBox& LocalBox);
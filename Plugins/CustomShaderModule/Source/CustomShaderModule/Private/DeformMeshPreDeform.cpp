@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DeformMeshPreDeform.h"
+#include "GlobalShader.h"
+#include "ShaderParameterUtils.h"
+#include "RHICommandList.h"
+#include "RHIResources.h"
+
+#include "DeformMeshRendering.h"
+#include "DeformMeshDeformers.h"
+
+IMPLEMENT_SHADER_TYPE(, FDeformMeshPreDeformCS, TEXT("/Plugin/CustomShaderModule/Private/DeformMeshPreDeform.usf"), TEXT("MainCS"), SF_Compute);
+
+FDeformMeshPreDeformCS::FDeformMeshPreDeformCS(const ShaderMetaType::CompiledShaderInitializerType& Initializer)
+	: FGlobalShader(Initializer)
+{
+	Transforms.Bind(Initializer.ParameterMap, TEXT("DMTransforms"));
+	TransformBaseIndex.Bind(Initializer.ParameterMap, TEXT("TransformBaseIndex"));
+	FirstSlot.Bind(Initializer.ParameterMap, TEXT("FirstSlot"));
+	NumSlots.Bind(Initializer.ParameterMap, TEXT("NumSlots"));
+	NumVertices.Bind(Initializer.ParameterMap, TEXT("NumVertices"));
+	OutputBase.Bind(Initializer.ParameterMap, TEXT("OutputBase"));
+	LocalToWorld.Bind(Initializer.ParameterMap, TEXT("LocalToWorld"));
+	DeformerParams.Bind(Initializer.ParameterMap, TEXT("DMDeformerParams"));
+	DeformerParamBase.Bind(Initializer.ParameterMap, TEXT("DeformerParamBase"));
+	SourcePositions.Bind(Initializer.ParameterMap, TEXT("SourcePositions"));
+	OutPreDeformedPositions.Bind(Initializer.ParameterMap, TEXT("OutPreDeformedPositions"));
+}
+
+bool FDeformMeshPreDeformCS::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	const FPermutationDomain permutationVector(Parameters.PermutationId);
+	return IsDeformMeshPreDeformEnabled(Parameters.Platform) &&
+		IsDeformMeshDeformerEnabled((EDeformMeshDeformerKind)permutationVector.Get<FDeformerDim>());
+}
+
+void FDeformMeshPreDeformCS::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters,
+	FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZE"), ThreadGroupSize);
+	// vertex factory ͬһDMTransforms
+	OutEnvironment.SetDefine(TEXT("DEFORM_MESH_TRANSFORM_ENCODING"), (uint32)GetDeformTransformEncoding());
+}
+
+void FDeformMeshPreDeformCS::SetParameters(FRHICommandList& RHICmdList, FRHIShaderResourceView* InTransforms,
+	uint32 InTransformBaseIndex, FRHIShaderResourceView* InDeformerParams, const FMatrix& InLocalToWorld,
+	FRHIUnorderedAccessView* InOutput, const FDeformMeshPreDeformDispatch& Dispatch)
+{
+	FRHIComputeShader* shaderRHI = RHICmdList.GetBoundComputeShader();
+
+	SetSRVParameter(RHICmdList, shaderRHI, Transforms, InTransforms);
+	SetShaderValue(RHICmdList, shaderRHI, TransformBaseIndex, InTransformBaseIndex);
+	SetShaderValue(RHICmdList, shaderRHI, FirstSlot, Dispatch.FirstSlot);
+	SetShaderValue(RHICmdList, shaderRHI, NumSlots, Dispatch.NumSlots);
+	SetShaderValue(RHICmdList, shaderRHI, NumVertices, Dispatch.NumVertices);
+	SetShaderValue(RHICmdList, shaderRHI, OutputBase, Dispatch.OutputBase);
+	SetShaderValue(RHICmdList, shaderRHI, LocalToWorld, InLocalToWorld);
+	// Rigid permutation û
+	SetSRVParameter(RHICmdList, shaderRHI, DeformerParams, InDeformerParams);
+	SetShaderValue(RHICmdList, shaderRHI, DeformerParamBase, Dispatch.DeformerParamBase);
+	SetSRVParameter(RHICmdList, shaderRHI, SourcePositions, Dispatch.SourcePositions);
+	SetUAVParameter(RHICmdList, shaderRHI, OutPreDeformedPositions, InOutput);
+}
+
+void FDeformMeshPreDeformCS::UnbindBuffers(FRHICommandList& RHICmdList)
+{
+	FRHIComputeShader* shaderRHI = RHICmdList.GetBoundComputeShader();
+
+	SetSRVParameter(RHICmdList, shaderRHI, Transforms, nullptr);
+	SetSRVParameter(RHICmdList, shaderRHI, DeformerParams, nullptr);
+	SetSRVParameter(RHICmdList, shaderRHI, SourcePositions, nullptr);
+	SetUAVParameter(RHICmdList, shaderRHI, OutPreDeformedPositions, nullptr);
+}
+
+void DispatchDeformMeshPreDeform(FRHICommandList& RHICmdList, ERHIFeatureLevel::Type FeatureLevel,
+	FRHIShaderResourceView* TransformsSRV, uint32 TransformBaseIndex, FRHIShaderResourceView* DeformerParamsSRV,
+	const FMatrix& LocalToWorld, FRHIUnorderedAccessView* OutputUAV, TArrayView<const FDeformMeshPreDeformDispatch> Dispatches)
+{
+	if (Dispatches.Num() == 0)
+	{
+		return;
+	}
+
+	FGlobalShaderMap* shaderMap = GetGlobalShaderMap(FeatureLevel);
+
+	RHICmdList.Transition(FRHITransitionInfo(OutputUAV, ERHIAccess::Unknown, ERHIAccess::UAVCompute));
+
+	// ÿdispatch дͬ, ҪUAV barrier
+	RHICmdList.BeginUAVOverlap(OutputUAV);
+	for (const FDeformMeshPreDeformDispatch& dispatch : Dispatches)
+	{
+		// dispatch group , ͬһgroup deformer ͬ
+		FDeformMeshPreDeformCS::FPermutationDomain permutationVector;
+		permutationVector.Set<FDeformMeshPreDeformCS::FDeformerDim>((int32)dispatch.DeformerKind);
+		TShaderMapRef<FDeformMeshPreDeformCS> computeShader(shaderMap, permutationVector);
+		RHICmdList.SetComputeShader(computeShader.GetComputeShader());
+
+		const uint32 numGroupsX = FMath::DivideAndRoundUp(dispatch.NumVertices, FDeformMeshPreDeformCS::ThreadGroupSize);
+
+		// thread group y 65535, section ̫ʱּdispatch
+		for (uint32 slotOffset = 0; slotOffset < dispatch.NumSlots; slotOffset += 65535)
+		{
+			FDeformMeshPreDeformDispatch chunk = dispatch;
+			chunk.FirstSlot = dispatch.FirstSlot + slotOffset;
+			chunk.NumSlots = FMath::Min<uint32>(dispatch.NumSlots - slotOffset, 65535);
+
+			computeShader->SetParameters(RHICmdList, TransformsSRV, TransformBaseIndex, DeformerParamsSRV, LocalToWorld, OutputUAV, chunk);
+			RHICmdList.DispatchComputeShader(numGroupsX, chunk.NumSlots, 1);
+		}
+
+		computeShader->UnbindBuffers(RHICmdList);
+	}
+	RHICmdList.EndUAVOverlap(OutputUAV);
+
+	RHICmdList.Transition(FRHITransitionInfo(OutputUAV, ERHIAccess::UAVCompute, ERHIAccess::SRVMask));
+}
+
+FVector DeformMeshPreDeformPosition(const FVector& LocalPosition, const FMatrix& DeformTransform, const FMatrix& LocalToWorld)
+{
+	// shader DeformTransform[k] תþĵk 
+	const FVector deformedPosition(
+		DeformTransform.M[0][0] * LocalPosition.X + DeformTransform.M[1][0] * LocalPosition.Y + DeformTransform.M[2][0] * LocalPosition.Z,
+		DeformTransform.M[0][1] * LocalPosition.X + DeformTransform.M[1][1] * LocalPosition.Y + DeformTransform.M[2][1] * LocalPosition.Z,
+		DeformTransform.M[0][2] * LocalPosition.X + DeformTransform.M[1][2] * LocalPosition.Y + DeformTransform.M[2][2] * LocalPosition.Z);
+	const FVector deformOrigin(DeformTransform.M[3][0], DeformTransform.M[3][1], DeformTransform.M[3][2]);
+	const FVector originalPosition = LocalToWorld.TransformPosition(LocalPosition);
+
+	float d = FMath::Min(FVector::Dist(originalPosition, deformOrigin), 100.f) / 100.f;
+	d = FMath::Square(d);
+	return FMath::Lerp(deformedPosition, originalPosition, d);
+}
+
+void DeformMeshPreDeformPositions(TArrayView<const FVector> LocalPositions, const FMatrix& DeformTransform,
+	const FMatrix& LocalToWorld, TArrayView<FVector> OutPositions)
+{
+	check(LocalPositions.Num() == OutPositions.Num());
+	for (int32 i = 0; i < LocalPositions.Num(); i++)
+	{
+		OutPositions[i] = DeformMeshPreDeformPosition(LocalPositions[i], DeformTransform, LocalToWorld);
+	}
+}
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameters.h"
+#include "ShaderPermutation.h"
+#include "DeformMeshComponent.h"
+
+/**
+ * һpre deform dispatch: һsource LOD һtransform slot
+ */
+struct FDeformMeshPreDeformDispatch
+{
+	// source LOD position vertex buffer SRV, ÿ3 float
+	FRHIShaderResourceView* SourcePositions;
+
+	uint32 NumVertices;
+
+	// [FirstSlot, FirstSlot + NumSlots)
+	uint32 FirstSlot;
+	uint32 NumSlots;
+
+	// slot 0 buffer еλ (λǶ), vertex factory DMPreDeformedBase ͬ
+	int32 OutputBase;
+
+	// Щslot deformer slot 0 Ĳλ, vertex factory DMDeformerParamBase ͬ
+	EDeformMeshDeformerKind DeformerKind;
+	int32 DeformerParamBase;
+};
+
+/**
+ * section Ķdeform world space, дһbuffer , vertex factory ֱӶȡ
+ * ֻtransform 仯ʱ, ÿpass ÿ֡vertex shader ¼
+ */
+class FDeformMeshPreDeformCS : public FGlobalShader
+{
+	DECLARE_SHADER_TYPE(FDeformMeshPreDeformCS, Global)
+
+public:
+	static constexpr uint32 ThreadGroupSize = 64;
+
+	// ÿdeformer һpermutation, vertex factory һֻ򿪵
+	class FDeformerDim : SHADER_PERMUTATION_INT("DEFORM_MESH_DEFORMER", 5);
+	using FPermutationDomain = TShaderPermutationDomain<FDeformerDim>;
+
+	FDeformMeshPreDeformCS()
+	{
+
+	}
+
+	FDeformMeshPreDeformCS(const ShaderMetaType::CompiledShaderInitializerType& Initializer);
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters,
+		FShaderCompilerEnvironment& OutEnvironment);
+
+	void SetParameters(FRHICommandList& RHICmdList, FRHIShaderResourceView* InTransforms, uint32 InTransformBaseIndex,
+		FRHIShaderResourceView* InDeformerParams, const FMatrix& InLocalToWorld, FRHIUnorderedAccessView* InOutput,
+		const FDeformMeshPreDeformDispatch& Dispatch);
+
+	void UnbindBuffers(FRHICommandList& RHICmdList);
+
+private:
+	LAYOUT_FIELD(FShaderResourceParameter, Transforms);
+	LAYOUT_FIELD(FShaderParameter, TransformBaseIndex);
+	LAYOUT_FIELD(FShaderParameter, FirstSlot);
+	LAYOUT_FIELD(FShaderParameter, NumSlots);
+	LAYOUT_FIELD(FShaderParameter, NumVertices);
+	LAYOUT_FIELD(FShaderParameter, OutputBase);
+	LAYOUT_FIELD(FShaderParameter, LocalToWorld);
+	LAYOUT_FIELD(FShaderResourceParameter, DeformerParams);
+	LAYOUT_FIELD(FShaderParameter, DeformerParamBase);
+	LAYOUT_FIELD(FShaderResourceParameter, SourcePositions);
+	LAYOUT_FIELD(FShaderResourceParameter, OutPreDeformedPositions);
+};
+
+/**
+ * RHICmdList ִһdispatch, Ƕͬһtransform slice deformer , дͬһbuffer
+ * buffer ڿʼʱtransition UAV, transition SRV vertex shader ȡ
+ * DeformerParamsSRV ֻзRigid dispatch ʱҪ
+ */
+void DispatchDeformMeshPreDeform(FRHICommandList& RHICmdList, ERHIFeatureLevel::Type FeatureLevel,
+	FRHIShaderResourceView* TransformsSRV, uint32 TransformBaseIndex, FRHIShaderResourceView* DeformerParamsSRV,
+	const FMatrix& LocalToWorld, FRHIUnorderedAccessView* OutputUAV, TArrayView<const FDeformMeshPreDeformDispatch> Dispatches);
+
+/**
+ * DeformMeshPreDeform.usf CPU 汾, ֤compute pass Ľ
+ * DeformTransform DeformTransforms һתù, world space λ
+ * LocalPosition ѾApplyDeformMeshDeformer λ
+ */
+FVector DeformMeshPreDeformPosition(const FVector& LocalPosition, const FMatrix& DeformTransform, const FMatrix& LocalToWorld);
+
+/** DeformMeshPreDeformPosition 汾, OutPositions LocalPositions һ */
+void DeformMeshPreDeformPositions(TArrayView<const FVector> LocalPositions, const FMatrix& DeformTransform,
+	const FMatrix& LocalToWorld, TArrayView<FVector> OutPositions);
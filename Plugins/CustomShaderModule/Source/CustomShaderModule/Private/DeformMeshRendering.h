@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHIDefinitions.h"
+#include "DeformMeshComponent.h"
+
+class FPrimitiveSceneProxy;
+class FSceneView;
+
+/**
+ * DMTransforms һtransform ı뷽ʽ, shader е DEFORM_MESH_TRANSFORM_ENCODING Ӧ
+ */
+enum class EDeformTransformEncoding : uint8
+{
+	Matrix4x4 = 0,
+	Affine3x4 = 1,
+	QuatTranslationScale = 2,
+};
+
+/**  r.DeformMesh.TransformEncoding, vertex factory compute shader ͬһ */
+EDeformTransformEncoding GetDeformTransformEncoding();
+
+/** һtransform DMTransforms ռfloat4 */
+int32 GetDeformTransformStride(EDeformTransformEncoding Encoding);
+
+/** r.DeformMesh.PreDeform 򿪲ƽ̨֧compute shader */
+bool IsDeformMeshPreDeformEnabled(EShaderPlatform Platform);
+
+/** r.DeformMesh.Deformers deformer, Rigid Ǵ򿪵 */
+bool IsDeformMeshDeformerEnabled(EDeformMeshDeformerKind Kind);
+
+/**
+ * game thread worker thread push section ¼¼ (transform, ɼ, FinishDeformUpdate)
+ * ÿview family Ⱦ֮ǰһ, ûȾʱҲgame thread ڴ
+ */
+void DrainDeformMeshUpdateQueue_RenderThread();
+
+/**
+ * benchmark , proxy ϲGetDynamicMeshElements section  (޳, ѡLOD, mesh batch)
+ * Proxy UDeformMeshComponent SceneProxy, ÿαƽ
+ */
+double TimeDeformMeshSectionIteration_RenderThread(const FPrimitiveSceneProxy* Proxy, const FSceneView& View,
+	int32 NumIterations, int32& OutNumBatchElements);
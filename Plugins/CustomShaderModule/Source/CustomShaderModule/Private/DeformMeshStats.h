@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Stat group for the deform mesh rendering path, "stat DeformMesh" in the console
+ */
+DECLARE_STATS_GROUP(TEXT("DeformMesh"), STATGROUP_DeformMesh, STATCAT_Advanced);
+
+/**
+ * Insights trace channel of the plugin, "-trace=cpu,DeformMesh" or "Trace.Enable DeformMesh"
+ */
+UE_TRACE_CHANNEL_EXTERN(DeformMeshChannel);
+
+/**
+ * cycle stat DeformMesh channel ϵCPU event ͬʱ¼һscope, event ־stat 
+ */
+#define SCOPE_DEFORM_MESH_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, DeformMeshChannel)
+
+/**
+ * plugin LLM еtag,  "stat LLMFULL" еDeformMesh
+ * proxy CPU ݺrender thread buffer tag ·
+ */
+DECLARE_LLM_MEMORY_STAT(TEXT("DeformMesh"), STAT_DeformMeshLLM, STATGROUP_LLMFULL);
+
+#define LLM_SCOPE_DEFORM_MESH() LLM_SCOPED_TAG_WITH_STAT(STAT_DeformMeshLLM, ELLMTracker::Default)
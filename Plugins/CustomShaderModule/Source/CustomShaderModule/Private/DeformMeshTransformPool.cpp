@@ -0,0 +1,421 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DeformMeshTransformPool.h"
+#include "RHICommandList.h"
+#include "RenderingThread.h"
+#include "SceneViewExtension.h"
+#include "HAL/IConsoleManager.h"
+#include "Containers/BitArray.h"
+#include "Algo/BinarySearch.h"
+
+#include "DeformMeshStats.h"
+#include "DeformMeshRendering.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDeformMeshTransformPool, Log, All);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Transform Bytes Uploaded"), STAT_DeformMeshUploadedBytes, STATGROUP_DeformMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Transform Upload Ranges"), STAT_DeformMeshUploadRanges, STATGROUP_DeformMesh);
+DECLARE_CYCLE_STAT(TEXT("Transform Pool Flush"), STAT_DeformMeshTransformPoolFlush, STATGROUP_DeformMesh);
+DECLARE_MEMORY_STAT(TEXT("Transform Pool Memory"), STAT_DeformMeshTransformPoolBytes, STATGROUP_DeformMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Transform Pool Pages"), STAT_DeformMeshTransformPoolPages, STATGROUP_DeformMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Transform Pool Used Slots"), STAT_DeformMeshTransformPoolUsedSlots, STATGROUP_DeformMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Transform Pool Free Slots"), STAT_DeformMeshTransformPoolFreeSlots, STATGROUP_DeformMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Transform Pool Free Blocks"), STAT_DeformMeshTransformPoolFreeBlocks, STATGROUP_DeformMesh);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Transform Pool Fragmentation"), STAT_DeformMeshTransformPoolFragmentation, STATGROUP_DeformMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Transform Pool Pages Released"), STAT_DeformMeshTransformPoolPagesReleased, STATGROUP_DeformMesh);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Transform Pool Blocks Coalesced"), STAT_DeformMeshTransformPoolBlocksCoalesced, STATGROUP_DeformMesh);
+
+static TAutoConsoleVariable<int32> CVarDeformMeshTransformPoolPageSize(
+	TEXT("r.DeformMesh.TransformPoolPageSize"),
+	16384,
+	TEXT("Number of transform slots in each page of the shared deform transform buffer.\n")
+	TEXT("A proxy needs TransformBufferDepth slots per section, larger proxies get a page of their own."),
+	ECVF_RenderThreadSafe);
+
+TGlobalResource<FDeformMeshTransformPool> GDeformMeshTransformPool;
+
+void BuildDirtyRanges(const TBitArray<>& DirtyBits, int32 MaxGap, TArray<FDeformTransformRange>& OutRanges)
+{
+	OutRanges.Reset();
+	for (TConstSetBitIterator<> it(DirtyBits); it; ++it)
+	{
+		const int32 index = it.GetIndex();
+		if (OutRanges.Num() > 0)
+		{
+			FDeformTransformRange& last = OutRanges.Last();
+			if (index - (last.First + last.Num) <= MaxGap)
+			{
+				last.Num = index - last.First + 1;
+				continue;
+			}
+		}
+		OutRanges.Add({ index, 1 });
+	}
+}
+
+bool FDeformMeshTransformPool::UseScatterUpload()
+{
+	// ByteBuffer.usf scatter copy ҪSM5
+	return GMaxRHIFeatureLevel >= ERHIFeatureLevel::SM5;
+}
+
+int32 FDeformMeshTransformPool::GetStride() const
+{
+	return GetDeformTransformStride(GetDeformTransformEncoding());
+}
+
+int32 FDeformMeshTransformPool::AllocateFromPage(FPage& Page, int32 NumSlots)
+{
+	for (int32 blockIndex = 0; blockIndex < Page.FreeBlocks.Num(); blockIndex++)
+	{
+		FFreeBlock& block = Page.FreeBlocks[blockIndex];
+		if (block.Num < NumSlots)
+		{
+			continue;
+		}
+
+		const int32 offset = block.Offset;
+		block.Offset += NumSlots;
+		block.Num -= NumSlots;
+		if (block.Num == 0)
+		{
+			Page.FreeBlocks.RemoveAt(blockIndex);
+		}
+		Page.NumUsedSlots += NumSlots;
+		return offset;
+	}
+	return INDEX_NONE;
+}
+
+FDeformMeshTransformAllocation FDeformMeshTransformPool::Allocate(int32 NumSlots)
+{
+	check(IsInRenderingThread());
+	check(NumSlots > 0);
+
+	FDeformMeshTransformAllocation allocation;
+	allocation.Num = NumSlots;
+
+	for (int32 pageIndex = 0; pageIndex < Pages.Num(); pageIndex++)
+	{
+		if (Pages[pageIndex].IsValid())
+		{
+			allocation.Offset = AllocateFromPage(*Pages[pageIndex], NumSlots);
+			if (allocation.Offset != INDEX_NONE)
+			{
+				allocation.PageIndex = pageIndex;
+				UpdateStats();
+				return allocation;
+			}
+		}
+	}
+
+#pragma region CreatePage
+	// û㹻Ŀп, ʹñͷŵpage µλ
+	int32 pageIndex = Pages.IndexOfByPredicate([](const TUniquePtr<FPage>& Page) { return !Page.IsValid(); });
+	if (pageIndex == INDEX_NONE)
+	{
+		pageIndex = Pages.AddDefaulted();
+	}
+	Pages[pageIndex] = MakeUnique<FPage>();
+	FPage& page = *Pages[pageIndex];
+
+	const int32 stride = GetStride();
+	page.NumSlots = FMath::Max(CVarDeformMeshTransformPoolPageSize.GetValueOnRenderThread(), NumSlots);
+	page.FreeBlocks.Add({ 0, page.NumSlots });
+	page.ShadowData.SetNumZeroed(page.NumSlots * stride);
+	page.DirtySlots.Init(false, page.NumSlots);
+
+	FRHIResourceCreateInfo createInfo;
+	// õDebugNameΪܹRenderDocҵ
+	createInfo.DebugName = TEXT("DeformMesh_TransformPoolSB");
+	const bool bScatterUpload = UseScatterUpload();
+	page.Buffer.NumBytes = page.NumSlots * stride * sizeof(FVector4);
+	page.Buffer.Buffer = RHICreateStructuredBuffer(sizeof(FVector4), page.Buffer.NumBytes,
+		bScatterUpload ? BUF_Static | BUF_ShaderResource | BUF_UnorderedAccess : BUF_Dynamic | BUF_ShaderResource, createInfo);
+	page.Buffer.SRV = RHICreateShaderResourceView(page.Buffer.Buffer);
+	if (bScatterUpload)
+	{
+		page.Buffer.UAV = RHICreateUnorderedAccessView(page.Buffer.Buffer, false, false);
+	}
+#pragma endregion
+
+	allocation.Offset = AllocateFromPage(page, NumSlots);
+	allocation.PageIndex = pageIndex;
+	UpdateStats();
+	return allocation;
+}
+
+void FDeformMeshTransformPool::Free(FDeformMeshTransformAllocation& Allocation)
+{
+	check(IsInRenderingThread());
+	if (!Allocation.IsValid())
+	{
+		return;
+	}
+
+	FPage& page = *Pages[Allocation.PageIndex];
+	page.NumUsedSlots -= Allocation.Num;
+
+	if (page.NumUsedSlots == 0)
+	{
+		// page , ͷGPU buffer, ڷеframe RHI ӳɾ
+		Pages[Allocation.PageIndex].Reset();
+		NumPagesReleased++;
+	}
+	else
+	{
+		// 뵽offset λ, ǰڵĿпϲ
+		const int32 insertIndex = Algo::LowerBoundBy(page.FreeBlocks, Allocation.Offset, &FFreeBlock::Offset);
+		page.FreeBlocks.Insert({ Allocation.Offset, Allocation.Num }, insertIndex);
+
+		int32 blockIndex = insertIndex;
+		if (blockIndex > 0)
+		{
+			FFreeBlock& prev = page.FreeBlocks[blockIndex - 1];
+			if (prev.Offset + prev.Num == Allocation.Offset)
+			{
+				prev.Num += Allocation.Num;
+				page.FreeBlocks.RemoveAt(blockIndex);
+				blockIndex--;
+				NumBlocksCoalesced++;
+			}
+		}
+		if (blockIndex + 1 < page.FreeBlocks.Num())
+		{
+			FFreeBlock& block = page.FreeBlocks[blockIndex];
+			const FFreeBlock& next = page.FreeBlocks[blockIndex + 1];
+			if (block.Offset + block.Num == next.Offset)
+			{
+				block.Num += next.Num;
+				page.FreeBlocks.RemoveAt(blockIndex + 1);
+				NumBlocksCoalesced++;
+			}
+		}
+	}
+
+	Allocation = FDeformMeshTransformAllocation();
+	UpdateStats();
+}
+
+void FDeformMeshTransformPool::Write(const FDeformMeshTransformAllocation& Allocation, int32 FirstSlot,
+	const FVector4* Data, int32 Num)
+{
+	check(IsInRenderingThread());
+	check(Allocation.IsValid() && FirstSlot >= 0 && FirstSlot + Num <= Allocation.Num);
+
+	FPage& page = *Pages[Allocation.PageIndex];
+	const int32 stride = GetStride();
+	const int32 pageSlot = Allocation.Offset + FirstSlot;
+	FMemory::Memcpy(&page.ShadowData[pageSlot * stride], Data, Num * stride * sizeof(FVector4));
+	page.DirtySlots.SetRange(pageSlot, Num, true);
+	page.bDirty = true;
+}
+
+FRHIShaderResourceView* FDeformMeshTransformPool::GetSRV(const FDeformMeshTransformAllocation& Allocation) const
+{
+	return Allocation.IsValid() ? Pages[Allocation.PageIndex]->Buffer.SRV.GetReference() : nullptr;
+}
+
+void FDeformMeshTransformPool::AddUploadListener(IDeformMeshTransformUploadListener* Listener)
+{
+	check(IsInRenderingThread());
+	UploadListeners.AddUnique(Listener);
+}
+
+void FDeformMeshTransformPool::RemoveUploadListener(IDeformMeshTransformUploadListener* Listener)
+{
+	check(IsInRenderingThread());
+	UploadListeners.RemoveSwap(Listener);
+}
+
+void FDeformMeshTransformPool::Flush(FRHICommandListImmediate& RHICmdList)
+{
+	check(IsInRenderingThread());
+
+#pragma region UploadDirtySlots
+	const int32 stride = GetStride();
+	const uint32 slotBytes = stride * sizeof(FVector4);
+	for (const TUniquePtr<FPage>& page : Pages)
+	{
+		if (!page.IsValid() || !page->bDirty)
+		{
+			continue;
+		}
+
+		SCOPE_DEFORM_MESH_CYCLE_COUNTER(STAT_DeformMeshTransformPoolFlush);
+
+		if (page->Buffer.UAV)
+		{
+			// proxy һ֡дslot һϴ, upload buffer ÿζд,
+			// Ƶpage GPU Ϻ֮ǰȡpage draw ˳ִ, ȴҲdriver page
+			BuildDirtyRanges(page->DirtySlots, 0, DirtyRanges);
+			int32 numDirtySlots = 0;
+			for (const FDeformTransformRange& range : DirtyRanges)
+			{
+				numDirtySlots += range.Num;
+			}
+
+			page->Uploader.Init(numDirtySlots, slotBytes, true, TEXT("DeformMesh_TransformPoolUpload"));
+			for (const FDeformTransformRange& range : DirtyRanges)
+			{
+				for (int32 slot = range.First; slot < range.First + range.Num; slot++)
+				{
+					page->Uploader.Add(slot, &page->ShadowData[slot * stride]);
+				}
+			}
+
+			RHICmdList.Transition(FRHITransitionInfo(page->Buffer.UAV, ERHIAccess::Unknown, ERHIAccess::UAVCompute));
+			page->Uploader.ResourceUploadTo(RHICmdList, page->Buffer);
+			RHICmdList.Transition(FRHITransitionInfo(page->Buffer.UAV, ERHIAccess::UAVCompute, ERHIAccess::SRVMask));
+
+			INC_DWORD_STAT_BY(STAT_DeformMeshUploadedBytes, numDirtySlots * slotBytes);
+			INC_DWORD_STAT_BY(STAT_DeformMeshUploadRanges, DirtyRanges.Num());
+		}
+		else
+		{
+			// BUF_Dynamic lock ᶪbuffer ԭȫ, ֻдһֵĻslot Ͷ, page CPU ϴ
+			void* sbData = RHILockStructuredBuffer(page->Buffer.Buffer, 0, page->Buffer.NumBytes, RLM_WriteOnly);
+			FMemory::Memcpy(sbData, page->ShadowData.GetData(), page->Buffer.NumBytes);
+			RHIUnlockStructuredBuffer(page->Buffer.Buffer);
+
+			INC_DWORD_STAT_BY(STAT_DeformMeshUploadedBytes, page->Buffer.NumBytes);
+			INC_DWORD_STAT(STAT_DeformMeshUploadRanges);
+		}
+
+		page->DirtySlots.Init(false, page->NumSlots);
+		page->bDirty = false;
+	}
+#pragma endregion
+
+	// listener ڻصпٴAdd, һFlush
+	TArray<IDeformMeshTransformUploadListener*, TInlineAllocator<16>> listeners(UploadListeners);
+	UploadListeners.Reset();
+	for (IDeformMeshTransformUploadListener* listener : listeners)
+	{
+		listener->OnTransformsUploaded_RenderThread(RHICmdList);
+	}
+}
+
+void FDeformMeshTransformPool::ReleaseRHI()
+{
+	Pages.Empty();
+	UploadListeners.Empty();
+}
+
+void FDeformMeshTransformPool::UpdateStats() const
+{
+	const int32 stride = GetStride();
+	uint32 numPages = 0;
+	uint32 totalBytes = 0;
+	uint32 usedSlots = 0;
+	uint32 freeSlots = 0;
+	uint32 freeBlocks = 0;
+	uint32 largestFreeBlock = 0;
+	for (const TUniquePtr<FPage>& page : Pages)
+	{
+		if (!page.IsValid())
+		{
+			continue;
+		}
+
+		numPages++;
+		totalBytes += page->NumSlots * stride * sizeof(FVector4);
+		usedSlots += page->NumUsedSlots;
+		freeSlots += page->NumSlots - page->NumUsedSlots;
+		freeBlocks += page->FreeBlocks.Num();
+		for (const FFreeBlock& block : page->FreeBlocks)
+		{
+			largestFreeBlock = FMath::Max<uint32>(largestFreeBlock, block.Num);
+		}
+	}
+
+	// еslot ȫʱ0, Խӽ1 Խѷ
+	const float fragmentation = freeSlots > 0 ? 1.f - (float)largestFreeBlock / freeSlots : 0.f;
+
+	SET_MEMORY_STAT(STAT_DeformMeshTransformPoolBytes, totalBytes);
+	SET_DWORD_STAT(STAT_DeformMeshTransformPoolPages, numPages);
+	SET_DWORD_STAT(STAT_DeformMeshTransformPoolUsedSlots, usedSlots);
+	SET_DWORD_STAT(STAT_DeformMeshTransformPoolFreeSlots, freeSlots);
+	SET_DWORD_STAT(STAT_DeformMeshTransformPoolFreeBlocks, freeBlocks);
+	SET_FLOAT_STAT(STAT_DeformMeshTransformPoolFragmentation, fragmentation);
+	SET_DWORD_STAT(STAT_DeformMeshTransformPoolPagesReleased, NumPagesReleased);
+	SET_DWORD_STAT(STAT_DeformMeshTransformPoolBlocksCoalesced, NumBlocksCoalesced);
+}
+
+void FDeformMeshTransformPool::LogStats() const
+{
+	const int32 stride = GetStride();
+	for (int32 pageIndex = 0; pageIndex < Pages.Num(); pageIndex++)
+	{
+		const FPage* page = Pages[pageIndex].Get();
+		if (page == nullptr)
+		{
+			continue;
+		}
+
+		int32 largestFreeBlock = 0;
+		for (const FFreeBlock& block : page->FreeBlocks)
+		{
+			largestFreeBlock = FMath::Max(largestFreeBlock, block.Num);
+		}
+		const int32 freeSlots = page->NumSlots - page->NumUsedSlots;
+
+		UE_LOG(LogDeformMeshTransformPool, Log, TEXT("Page %d: %d / %d slots used, %.1f KB, %d free blocks, largest %d, fragmentation %.2f"),
+			pageIndex, page->NumUsedSlots, page->NumSlots, page->NumSlots * stride * sizeof(FVector4) / 1024.f,
+			page->FreeBlocks.Num(), largestFreeBlock, freeSlots > 0 ? 1.f - (float)largestFreeBlock / freeSlots : 0.f);
+	}
+	UE_LOG(LogDeformMeshTransformPool, Log, TEXT("%d pages released, %d free blocks coalesced"), NumPagesReleased, NumBlocksCoalesced);
+}
+
+static FAutoConsoleCommand CmdDeformMeshTransformPoolStats(
+	TEXT("r.DeformMesh.TransformPoolStats"),
+	TEXT("Logs the usage and fragmentation of every page of the shared deform transform buffer."),
+	FConsoleCommandDelegate::CreateLambda([]()
+		{
+			ENQUEUE_RENDER_COMMAND(FDeformMeshTransformPoolStats)(
+				[](FRHICommandListImmediate& RHICmdList)
+				{
+					GDeformMeshTransformPool.LogStats();
+				});
+		}));
+
+/**
+ * renderer ռɼ֮ǰһ֡section , ϴdeform mesh transform
+ * ϴ, дtransform render command ԼFlush, ֻǱ֤һ֡ĸȾ֮ǰЧ
+ */
+class FDeformMeshTransformPoolExtension : public FSceneViewExtensionBase
+{
+public:
+	FDeformMeshTransformPoolExtension(const FAutoRegister& AutoRegister)
+		: FSceneViewExtensionBase(AutoRegister)
+	{
+	}
+
+	void SetupViewFamily(FSceneViewFamily& InViewFamily) override {}
+	void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override {}
+	void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override {}
+
+	void PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily) override
+	{
+		// drain ֮Flush, ͬһ֡ĺview family ûµдʱʲôҲ
+		DrainDeformMeshUpdateQueue_RenderThread();
+	}
+
+	void PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView) override {}
+};
+
+static TSharedPtr<FDeformMeshTransformPoolExtension, ESPMode::ThreadSafe> GDeformMeshTransformPoolExtension;
+
+void RegisterDeformMeshTransformPoolExtension()
+{
+	if (!GDeformMeshTransformPoolExtension.IsValid())
+	{
+		GDeformMeshTransformPoolExtension = FSceneViewExtensions::NewExtension<FDeformMeshTransformPoolExtension>();
+	}
+}
+
+void UnregisterDeformMeshTransformPoolExtension()
+{
+	GDeformMeshTransformPoolExtension.Reset();
+}
@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderResource.h"
+#include "RHIResources.h"
+#include "RHIUtilities.h"
+#include "UnifiedBuffer.h"
+
+/**
+ * DMTransforms һslot [First, First + Num)
+ */
+struct FDeformTransformRange
+{
+	int32 First;
+	int32 Num;
+};
+
+/**
+ * dirty bits ϲ, MaxGap clean slot Ҳϲ
+ */
+void BuildDirtyRanges(const TBitArray<>& DirtyBits, int32 MaxGap, TArray<FDeformTransformRange>& OutRanges);
+
+/**
+ * FDeformMeshTransformPool зһslot, һslot һtransform
+ */
+struct FDeformMeshTransformAllocation
+{
+	int32 PageIndex = INDEX_NONE;
+
+	// page еλ, Ҳshader DMTransforms slot 
+	int32 Offset = 0;
+
+	int32 Num = 0;
+
+	inline bool IsValid() const { return PageIndex != INDEX_NONE; }
+};
+
+/**
+ * FDeformMeshTransformPool::Flush ϴһ֡transform ֪֮ͨʹ,
+ * ȡDMTransforms compute pass (pre deform) Ҫ֮dispatch
+ */
+class IDeformMeshTransformUploadListener
+{
+public:
+	virtual ~IDeformMeshTransformUploadListener() {}
+
+	virtual void OnTransformsUploaded_RenderThread(FRHICommandListImmediate& RHICmdList) = 0;
+};
+
+/**
+ * deform mesh proxy õDMTransforms, ֻrender thread ʹ
+ * ֳ r.DeformMesh.TransformPoolPageSize Сpage, ÿpage һstructured buffer,
+ * page ֮󲻻·, cached mesh draw command а󶨵SRV һֱЧ, ͬһpage proxy ͬһSRV
+ * page ðoffset free list first fit , ͷʱڵĿпϲ, ȫеpage ͷ
+ * Write ֻдCPU ˵ĸ, Flush ʱdirty slot дupload buffer, compute shader GPU scatter page,
+ * lock GPU ڶpage. ֧SM5 ʱpage BUF_Dynamic, page һlock (driver µڴ)
+ * дrender command ֮ǰFlush (drain update queue, proxy, section 仯֮), ֮κdraw ܶ
+ */
+class FDeformMeshTransformPool : public FRenderResource
+{
+public:
+	/** NumSlots slot, δ, ҪWrite */
+	FDeformMeshTransformAllocation Allocate(int32 NumSlots);
+
+	/** ͷ֮Allocation Ч */
+	void Free(FDeformMeshTransformAllocation& Allocation);
+
+	/** дNum slot, ÿslot GetStride() float4, FirstSlot Allocation Ŀʼ */
+	void Write(const FDeformMeshTransformAllocation& Allocation, int32 FirstSlot, const FVector4* Data, int32 Num);
+
+	/** Allocation page SRV */
+	FRHIShaderResourceView* GetSRV(const FDeformMeshTransformAllocation& Allocation) const;
+
+	/** һFlush ֮һListener, ֮ǰٵListener ҪRemoveUploadListener */
+	void AddUploadListener(IDeformMeshTransformUploadListener* Listener);
+
+	void RemoveUploadListener(IDeformMeshTransformUploadListener* Listener);
+
+	/** ϴWrite slot, Ȼ֪ͨlistener */
+	void Flush(FRHICommandListImmediate& RHICmdList);
+
+	/** ÿpage ʹƬͳ */
+	void LogStats() const;
+
+	/**  r.DeformMesh.TransformEncoding, һslot float4 */
+	int32 GetStride() const;
+
+	//~ FRenderResource
+	void ReleaseRHI() override;
+
+private:
+	struct FFreeBlock
+	{
+		int32 Offset;
+		int32 Num;
+	};
+
+	struct FPage
+	{
+		int32 NumSlots = 0;
+		int32 NumUsedSlots = 0;
+
+		// Offset , ڵĿѾϲ
+		TArray<FFreeBlock> FreeBlocks;
+
+		// GPU buffer CPU , dirty slot page ϴʱ
+		TArray<FVector4> ShadowData;
+		TBitArray<> DirtySlots;
+		bool bDirty = false;
+
+		// ֻBuffer SRV, ֧scatter upload ʱUAV
+		FRWBufferStructured Buffer;
+
+		// ÿpage һ, ͬһ֡Flush ʱpage upload buffer Ӱ
+		FScatterUploadBuffer Uploader;
+	};
+
+	/** Ƿcompute shader scatter ϴ, page BUF_Dynamic, ÿϴpage */
+	static bool UseScatterUpload();
+
+	/** page free list first fit, û㹻ĿпʱINDEX_NONE */
+	static int32 AllocateFromPage(FPage& Page, int32 NumSlots);
+
+	/** STATGROUP_DeformMesh pool ͳ */
+	void UpdateStats() const;
+
+	// ͷŵpage nullptr, page 
+	TArray<TUniquePtr<FPage>> Pages;
+
+	TArray<IDeformMeshTransformUploadListener*> UploadListeners;
+
+	// BuildDirtyRanges , ΪԱڴ
+	TArray<FDeformTransformRange> DirtyRanges;
+
+	// Ϊȫбͷŵpage 
+	int32 NumPagesReleased = 0;
+
+	// Free ʱڿпϲĴ
+	int32 NumBlocksCoalesced = 0;
+};
+
+extern TGlobalResource<FDeformMeshTransformPool> GDeformMeshTransformPool;
+
+/**
+ * עÿview family Ⱦ֮ǰdrain update queue Flush GDeformMeshTransformPool scene view extension
+ * ҪGEngine, game thread OnPostEngineInit е
+ */
+void RegisterDeformMeshTransformPoolExtension();
+
+void UnregisterDeformMeshTransformPoolExtension();
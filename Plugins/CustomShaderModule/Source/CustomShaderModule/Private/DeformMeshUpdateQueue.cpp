@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DeformMeshUpdateQueue.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformProcess.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDeformMeshUpdateQueue, Log, All);
+
+/**
+ * section transform ¼¼һС
+ */
+struct FDeformMeshStressRecord
+{
+	int32 Producer;
+	int32 Sequence;
+	FVector4 Payload[3];
+	uint8 Padding[8];
+};
+
+bool RunDeformMeshUpdateQueueStress(int32 NumProducers, int32 RecordsPerProducer, FString& OutSummary)
+{
+	const int32 numProducers = FMath::Clamp(NumProducers, 1, 64);
+	const int32 recordsPerProducer = FMath::Max(RecordsPerProducer, 1);
+
+	TDeformMeshMpscQueue<FDeformMeshStressRecord> queue;
+	std::atomic<int32> numProducersRunning{ numProducers };
+
+	const double startTime = FPlatformTime::Seconds();
+
+	TArray<TFuture<void>> producers;
+	for (int32 producerIndex = 0; producerIndex < numProducers; producerIndex++)
+	{
+		producers.Add(Async(EAsyncExecution::Thread, [&queue, &numProducersRunning, producerIndex, recordsPerProducer]()
+			{
+				FDeformMeshStressRecord record;
+				record.Producer = producerIndex;
+				for (int32 sequence = 0; sequence < recordsPerProducer; sequence++)
+				{
+					record.Sequence = sequence;
+					record.Payload[0].X = (float)sequence;
+					queue.Push(record);
+				}
+				numProducersRunning.fetch_sub(1, std::memory_order_release);
+			}));
+	}
+
+	// render thread һֻһ
+	TArray<int32> nextSequence;
+	nextSequence.SetNumZeroed(numProducers);
+	int64 numDrained = 0;
+	int32 numErrors = 0;
+	int32 numDrainCalls = 0;
+	auto consume = [&](const FDeformMeshStressRecord& Record)
+	{
+		if (Record.Sequence != nextSequence[Record.Producer] || Record.Payload[0].X != (float)Record.Sequence)
+		{
+			numErrors++;
+		}
+		nextSequence[Record.Producer] = Record.Sequence + 1;
+	};
+
+	for (;;)
+	{
+		// ȶȡǷ񶼽, Drain, ֮ǰPush ļ¼һܶ
+		const bool bProducersDone = numProducersRunning.load(std::memory_order_acquire) == 0;
+		const int32 drained = queue.Drain(consume);
+		numDrained += drained;
+		numDrainCalls++;
+		if (bProducersDone)
+		{
+			break;
+		}
+		if (drained == 0)
+		{
+			FPlatformProcess::Yield();
+		}
+	}
+
+	for (TFuture<void>& producer : producers)
+	{
+		producer.Wait();
+	}
+
+	const double seconds = FPlatformTime::Seconds() - startTime;
+	const int64 numExpected = (int64)numProducers * recordsPerProducer;
+	for (int32 producerIndex = 0; producerIndex < numProducers; producerIndex++)
+	{
+		if (nextSequence[producerIndex] != recordsPerProducer)
+		{
+			numErrors++;
+		}
+	}
+
+	const bool bPassed = numErrors == 0 && numDrained == numExpected;
+	OutSummary = FString::Printf(TEXT("%d producers, %lld / %lld records in %.3f s (%.1f M records/s), %d drain calls, %d errors: %s"),
+		numProducers, numDrained, numExpected, seconds, numDrained / seconds / 1000000.0, numDrainCalls, numErrors,
+		bPassed ? TEXT("passed") : TEXT("FAILED"));
+	return bPassed;
+}
+
+static void StressDeformMeshUpdateQueue(const TArray<FString>& Args)
+{
+	const int32 numProducers = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 4;
+	const int32 recordsPerProducer = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000000;
+
+	FString summary;
+	RunDeformMeshUpdateQueueStress(numProducers, recordsPerProducer, summary);
+	UE_LOG(LogDeformMeshUpdateQueue, Log, TEXT("%s"), *summary);
+}
+
+static FAutoConsoleCommand CmdDeformMeshUpdateQueueStress(
+	TEXT("r.DeformMesh.UpdateQueueStress"),
+	TEXT("Pushes records into a deform mesh update queue from several threads while draining it, checks ordering and loss.\n")
+	TEXT("Usage: r.DeformMesh.UpdateQueueStress [NumProducerThreads=4] [RecordsPerThread=1000000]\n")
+	TEXT("Blocks the calling thread until done."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&StressDeformMeshUpdateQueue));
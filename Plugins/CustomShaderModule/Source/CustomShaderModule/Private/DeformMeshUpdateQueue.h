@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTLS.h"
+#include <atomic>
+
+/**
+ * ĵߵ߶, û
+ * ¼ChunkSize Сchunk , Push ֻдǰchunk release д, ˲ŷ() һchunk
+ * ߶һchunk Ѿһchunk ֮ͷ, ʱ߲ٷ
+ */
+template<typename T, int32 ChunkSize = 1024>
+class TDeformMeshSpscQueue
+{
+public:
+	TDeformMeshSpscQueue()
+	{
+		Head = Tail = new FChunk();
+	}
+
+	~TDeformMeshSpscQueue()
+	{
+		while (Head)
+		{
+			FChunk* next = Head->Next.load(std::memory_order_relaxed);
+			delete Head;
+			Head = next;
+		}
+		delete Spare.load(std::memory_order_relaxed);
+	}
+
+	TDeformMeshSpscQueue(const TDeformMeshSpscQueue&) = delete;
+	TDeformMeshSpscQueue& operator=(const TDeformMeshSpscQueue&) = delete;
+
+	/** ֻһ̵߳ */
+	void Push(const T& Item)
+	{
+		if (TailIndex == ChunkSize)
+		{
+			// ߻chunk Ѿù
+			FChunk* chunk = Spare.exchange(nullptr, std::memory_order_acquire);
+			if (chunk == nullptr)
+			{
+				chunk = new FChunk();
+			}
+			Tail->Next.store(chunk, std::memory_order_release);
+			Tail = chunk;
+			TailIndex = 0;
+		}
+
+		Tail->Items[TailIndex++] = Item;
+		Tail->NumWritten.store(TailIndex, std::memory_order_release);
+	}
+
+	/** ֻһ̵߳, Push ˳ÿѾļ¼Func, ش */
+	template<typename FuncType>
+	int32 Drain(FuncType&& Func)
+	{
+		int32 numDrained = 0;
+		for (;;)
+		{
+			const int32 numWritten = Head->NumWritten.load(std::memory_order_acquire);
+			for (; Head->NumRead < numWritten; Head->NumRead++)
+			{
+				Func(Head->Items[Head->NumRead]);
+				numDrained++;
+			}
+
+			FChunk* next = numWritten == ChunkSize ? Head->Next.load(std::memory_order_acquire) : nullptr;
+			if (next == nullptr)
+			{
+				return numDrained;
+			}
+
+			FChunk* consumed = Head;
+			Head = next;
+
+			// һchunk ߸, Ѿ˾ͷ
+			consumed->NumWritten.store(0, std::memory_order_relaxed);
+			consumed->Next.store(nullptr, std::memory_order_relaxed);
+			consumed->NumRead = 0;
+			FChunk* expected = nullptr;
+			if (!Spare.compare_exchange_strong(expected, consumed, std::memory_order_release, std::memory_order_relaxed))
+			{
+				delete consumed;
+			}
+		}
+	}
+
+private:
+	struct FChunk
+	{
+		T Items[ChunkSize];
+
+		// ߷ļ¼
+		std::atomic<int32> NumWritten{ 0 };
+
+		std::atomic<FChunk*> Next{ nullptr };
+
+		// ֻ߷
+		int32 NumRead = 0;
+	};
+
+	// ʹ
+	FChunk* Tail;
+	int32 TailIndex = 0;
+
+	// ߵݷֿڲͬcache line
+	uint8 Padding[PLATFORM_CACHE_LINE_SIZE];
+
+	// ʹ
+	FChunk* Head;
+
+	std::atomic<FChunk*> Spare{ nullptr };
+};
+
+/**
+ * ߵߵİ汾: ÿ̵߳һPush ʱõԼTDeformMeshSpscQueue, ֮Push ûо
+ * ߶йһֻ, ֱͷ
+ * ֮ͬ߳ļ¼û˳, ͬһ̵߳ļ¼Push ˳
+ */
+template<typename T, int32 ChunkSize = 1024>
+class TDeformMeshMpscQueue
+{
+public:
+	TDeformMeshMpscQueue()
+		: TlsSlot(FPlatformTLS::AllocTlsSlot())
+	{
+	}
+
+	~TDeformMeshMpscQueue()
+	{
+		FPlatformTLS::FreeTlsSlot(TlsSlot);
+
+		FProducer* producer = Producers.load(std::memory_order_relaxed);
+		while (producer)
+		{
+			FProducer* next = producer->Next;
+			delete producer;
+			producer = next;
+		}
+	}
+
+	TDeformMeshMpscQueue(const TDeformMeshMpscQueue&) = delete;
+	TDeformMeshMpscQueue& operator=(const TDeformMeshMpscQueue&) = delete;
+
+	/** ̵߳ */
+	void Push(const T& Item)
+	{
+		FProducer* producer = static_cast<FProducer*>(FPlatformTLS::GetTlsValue(TlsSlot));
+		if (producer == nullptr)
+		{
+			producer = new FProducer();
+			FPlatformTLS::SetTlsValue(TlsSlot, producer);
+
+			producer->Next = Producers.load(std::memory_order_relaxed);
+			while (!Producers.compare_exchange_weak(producer->Next, producer, std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+		}
+		producer->Queue.Push(Item);
+	}
+
+	/** ֻһ̵߳, δÿѾļ¼ */
+	template<typename FuncType>
+	int32 Drain(FuncType&& Func)
+	{
+		int32 numDrained = 0;
+		for (FProducer* producer = Producers.load(std::memory_order_acquire); producer; producer = producer->Next)
+		{
+			numDrained += producer->Queue.Drain(Func);
+		}
+		return numDrained;
+	}
+
+private:
+	struct FProducer
+	{
+		TDeformMeshSpscQueue<T, ChunkSize> Queue;
+		FProducer* Next = nullptr;
+	};
+
+	const uint32 TlsSlot;
+
+	std::atomic<FProducer*> Producers{ nullptr };
+};
+
+/**
+ * ߳ͬʱPush, õ߳ͬʱDrain, ÿߵļ¼˳򵽴ﲢûжʧ
+ * OutSummary ǽ, ֱм¼, ɹtrue
+ */
+bool RunDeformMeshUpdateQueueStress(int32 NumProducers, int32 RecordsPerProducer, FString& OutSummary);
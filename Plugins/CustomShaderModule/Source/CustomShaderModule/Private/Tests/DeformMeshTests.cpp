@@ -0,0 +1,413 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/StaticMesh.h"
+#include "UObject/Package.h"
+#include "DeformMeshComponent.h"
+#include "DeformMeshDeformers.h"
+#include "DeformMeshPreDeform.h"
+#include "DeformMeshUpdateQueue.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DeformMeshTests
+{
+	// ֻCPU , -nullrhi Ҳ
+	constexpr uint32 TestFlags = EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	UStaticMesh* LoadTestMesh(FAutomationTestBase& Test)
+	{
+		UStaticMesh* mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+		if (mesh == nullptr)
+		{
+			Test.AddError(TEXT("Failed to load /Engine/BasicShapes/Cube"));
+		}
+		return mesh;
+	}
+
+	FTransform RandomDeformTransform(FRandomStream& Random)
+	{
+		const FRotator rotation(Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f), Random.FRandRange(-180.f, 180.f));
+		return FTransform(rotation, Random.VRand() * Random.FRandRange(0.f, 5000.f), FVector(Random.FRandRange(0.2f, 3.f)));
+	}
+
+	bool BoxesNearlyEqual(const FBox& A, const FBox& B, float Tolerance)
+	{
+		if (!A.IsValid || !B.IsValid)
+		{
+			return A.IsValid == B.IsValid;
+		}
+		return A.Min.Equals(B.Min, Tolerance) && A.Max.Equals(B.Max, Tolerance);
+	}
+}
+
+/**
+ * ʱƶ, ɾsection ֮, ÿsection bounds component LocalBounds
+ * Ҫʹӵǰtransform ¼Ľһ, Ϊۼӻ±
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDeformMeshSectionBoundsTest, "Plugins.DeformMesh.SectionBounds", DeformMeshTests::TestFlags)
+
+bool FDeformMeshSectionBoundsTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* mesh = DeformMeshTests::LoadTestMesh(*this);
+	if (mesh == nullptr)
+	{
+		return false;
+	}
+	const FBox meshBox = mesh->GetBoundingBox();
+
+	UDeformMeshComponent* deformCom = NewObject<UDeformMeshComponent>(GetTransientPackage());
+	FRandomStream random(9);
+
+	// Լ¼section ״̬, ¼bounds
+	TArray<FTransform> transforms;
+	TArray<bool> live;
+
+	auto addSection = [&]()
+	{
+		const FTransform transform = DeformMeshTests::RandomDeformTransform(random);
+		const int32 sectionIndex = deformCom->AddSection(mesh, transform);
+		if (sectionIndex >= live.Num())
+		{
+			transforms.SetNum(sectionIndex + 1);
+			live.SetNumZeroed(sectionIndex + 1);
+		}
+		transforms[sectionIndex] = transform;
+		live[sectionIndex] = true;
+	};
+
+	auto verifyBounds = [&](int32 Step)
+	{
+		FBox expectedLocalBox(ForceInit);
+		for (int32 sectionIndex = 0; sectionIndex < live.Num(); sectionIndex++)
+		{
+			const FBox expectedBox = live[sectionIndex] ? meshBox.TransformBy(transforms[sectionIndex]) : FBox(ForceInit);
+			if (!DeformMeshTests::BoxesNearlyEqual(deformCom->GetSectionBoundingBox(sectionIndex), expectedBox, 1e-3f))
+			{
+				AddError(FString::Printf(TEXT("Step %d: section %d bounds %s, expected %s"), Step, sectionIndex,
+					*deformCom->GetSectionBoundingBox(sectionIndex).ToString(), *expectedBox.ToString()));
+				return false;
+			}
+			expectedLocalBox += expectedBox;
+		}
+
+		// LocalBounds FBoxSphereBounds, ݲŴһ
+		const FBox localBox = deformCom->CalcBounds(FTransform::Identity).GetBox();
+		if (!DeformMeshTests::BoxesNearlyEqual(localBox, expectedLocalBox, 0.05f))
+		{
+			AddError(FString::Printf(TEXT("Step %d: local bounds %s, expected %s"), Step,
+				*localBox.ToString(), *expectedLocalBox.ToString()));
+			return false;
+		}
+		return true;
+	};
+
+	for (int32 i = 0; i < 256; i++)
+	{
+		addSection();
+	}
+
+	constexpr int32 numSteps = 50000;
+	for (int32 step = 0; step < numSteps; step++)
+	{
+		const int32 sectionIndex = random.RandHelper(live.Num());
+		const float action = random.FRand();
+		if (action < 0.02f && live[sectionIndex])
+		{
+			deformCom->ClearSection(sectionIndex);
+			live[sectionIndex] = false;
+		}
+		else if (action < 0.04f)
+		{
+			addSection();
+		}
+		else if (live[sectionIndex])
+		{
+			transforms[sectionIndex] = DeformMeshTests::RandomDeformTransform(random);
+			deformCom->UpdateSectionTransform(sectionIndex, transforms[sectionIndex]);
+		}
+
+		if ((step % 1000) == 0 && !verifyBounds(step))
+		{
+			return false;
+		}
+	}
+
+	return verifyBounds(numSteps);
+}
+
+/**
+ * 10k section ʱrender thread section Ŀ, ֻCPU ڴ沼, Ҫproxy
+ * ģݽṹ, proxy DeformMeshBenchmark commandlet  -ProxyIterations 
+ * ֮ǰ: ÿsection new Ķ, ɼ, index Ⱥindex buffer, vertex factory һ
+ * : FDeformMeshSceneProxy һ, ڰslot Ĳ, ͬһgroup source 
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDeformMeshSectionIterationBenchmark, "Plugins.DeformMesh.SectionIterationBenchmark", DeformMeshTests::TestFlags)
+
+bool FDeformMeshSectionIterationBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 numSections = 10000;
+	constexpr int32 numGroups = 8;
+	constexpr int32 numIterations = 200;
+
+	// ֮ǰFDeformMeshSectionProxy, ݵĴСindex buffer + vertex factory 
+	struct FHeapSectionProxy
+	{
+		uint8 ColdData[320];
+		UPTRINT SectionMaterial;
+		bool bSectionVisible;
+		uint32 NumPrimitives;
+		uint32 MaxVertexIndex;
+	};
+
+	struct FSourceData
+	{
+		// proxy ָ, 0 ûв
+		UPTRINT Material;
+		uint32 NumPrimitives;
+		uint32 MaxVertexIndex;
+	};
+
+	FRandomStream random(10);
+	TArray<FHeapSectionProxy*> heapSections;
+	TArray<void*> heapFillers;
+	TArray<uint8> slotVisible;
+	TArray<int32> slotGroups;
+	TArray<FSourceData> groups;
+	for (int32 groupIndex = 0; groupIndex < numGroups; groupIndex++)
+	{
+		groups.Add({ UPTRINT(groupIndex + 1), uint32(12 + groupIndex * 100), uint32(24 + groupIndex * 50) });
+	}
+
+	for (int32 i = 0; i < numSections; i++)
+	{
+		const int32 groupIndex = i * numGroups / numSections;
+		const bool bVisible = random.FRand() < 0.7f;
+
+		FHeapSectionProxy* section = new FHeapSectionProxy;
+		section->SectionMaterial = groups[groupIndex].Material;
+		section->bSectionVisible = bVisible;
+		section->NumPrimitives = groups[groupIndex].NumPrimitives;
+		section->MaxVertexIndex = groups[groupIndex].MaxVertexIndex;
+		heapSections.Add(section);
+		// 佻, proxy ʱһɢڶ
+		heapFillers.Add(FMemory::Malloc(random.RandRange(16, 512)));
+
+		slotVisible.Add(bVisible ? 1 : 0);
+		slotGroups.Add(groupIndex);
+	}
+
+	// GetDynamicMeshElements һ: ɼsection ǵ
+	uint64 heapTriangles = 0;
+	const double heapStart = FPlatformTime::Seconds();
+	for (int32 iteration = 0; iteration < numIterations; iteration++)
+	{
+		for (const FHeapSectionProxy* section : heapSections)
+		{
+			if (section->bSectionVisible && section->SectionMaterial != 0)
+			{
+				heapTriangles += section->NumPrimitives;
+			}
+		}
+	}
+	const double heapSeconds = FPlatformTime::Seconds() - heapStart;
+
+	uint64 slotTriangles = 0;
+	const double slotStart = FPlatformTime::Seconds();
+	for (int32 iteration = 0; iteration < numIterations; iteration++)
+	{
+		// group еslot , SetupGroupMeshBatch һgroup 
+		int32 slot = 0;
+		for (int32 groupIndex = 0; groupIndex < numGroups; groupIndex++)
+		{
+			const FSourceData& group = groups[groupIndex];
+			uint32 numVisible = 0;
+			for (; slot < numSections && slotGroups[slot] == groupIndex; slot++)
+			{
+				numVisible += slotVisible[slot];
+			}
+			if (group.Material != 0)
+			{
+				slotTriangles += uint64(numVisible) * group.NumPrimitives;
+			}
+		}
+	}
+	const double slotSeconds = FPlatformTime::Seconds() - slotStart;
+
+	for (FHeapSectionProxy* section : heapSections)
+	{
+		delete section;
+	}
+	for (void* filler : heapFillers)
+	{
+		FMemory::Free(filler);
+	}
+
+	TestEqual(TEXT("Both layouts count the same triangles"), int64(slotTriangles), int64(heapTriangles));
+	AddInfo(FString::Printf(TEXT("%d sections: heap objects %.2f us, parallel slot arrays %.2f us per iteration (%.1fx)"),
+		numSections, heapSeconds * 1e6 / numIterations, slotSeconds * 1e6 / numIterations,
+		heapSeconds / FMath::Max(slotSeconds, 1e-9)));
+	return true;
+}
+
+/**
+ * pre deform compute pass deformer CPU 汾, ĽȽ
+ * GPU Ľr.DeformMesh.ValidatePreDeform Ƚ, ԼǶԵ
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDeformMeshPreDeformReferenceTest, "Plugins.DeformMesh.PreDeformReference", DeformMeshTests::TestFlags)
+
+bool FDeformMeshPreDeformReferenceTest::RunTest(const FString& Parameters)
+{
+	constexpr float tolerance = 1e-3f;
+
+	auto applyDeformer = [](const FDeformMeshDeformer& Deformer, const FVector& Position)
+	{
+		TArray<FVector4> params;
+		PackDeformMeshDeformerParams(Deformer, params);
+		return ApplyDeformMeshDeformer(Deformer.Kind, params.GetData(), Position);
+	};
+
+	FDeformMeshDeformer rigid;
+	TestEqual(TEXT("Rigid"), applyDeformer(rigid, FVector(1.f, 2.f, 3.f)), FVector(1.f, 2.f, 3.f));
+
+	// 뾶100 Բ, z = 50 0.5 
+	FDeformMeshDeformer bend;
+	bend.Kind = EDeformMeshDeformerKind::Bend;
+	bend.Amount = 0.01f;
+	bend.MinZ = 0.f;
+	bend.MaxZ = 100.f;
+	TestEqual(TEXT("Bend inside range"), applyDeformer(bend, FVector(0.f, 0.f, 50.f)), FVector(12.241744f, 0.f, 47.942554f), tolerance);
+	// MaxZ 1 , ֮50
+	TestEqual(TEXT("Bend past MaxZ"), applyDeformer(bend, FVector(10.f, 5.f, 150.f)), FVector(93.446342f, 5.f, 102.747504f), tolerance);
+	TestEqual(TEXT("Bend at MinZ"), applyDeformer(bend, FVector(10.f, 5.f, 0.f)), FVector(10.f, 5.f, 0.f), tolerance);
+
+	// 0 100 Ťת90 
+	FDeformMeshDeformer twist;
+	twist.Kind = EDeformMeshDeformerKind::Twist;
+	twist.Amount = PI / 200.f;
+	twist.MinZ = 0.f;
+	twist.MaxZ = 100.f;
+	TestEqual(TEXT("Twist half way"), applyDeformer(twist, FVector(10.f, 0.f, 50.f)), FVector(7.071068f, 7.071068f, 50.f), tolerance);
+	TestEqual(TEXT("Twist past MaxZ"), applyDeformer(twist, FVector(10.f, 0.f, 300.f)), FVector(0.f, 10.f, 300.f), tolerance);
+
+	FDeformMeshDeformer taper;
+	taper.Kind = EDeformMeshDeformerKind::Taper;
+	taper.MinZ = 0.f;
+	taper.MaxZ = 100.f;
+	taper.TaperStartScale = 1.f;
+	taper.TaperEndScale = 0.5f;
+	TestEqual(TEXT("Taper half way"), applyDeformer(taper, FVector(10.f, 20.f, 50.f)), FVector(7.5f, 15.f, 50.f), tolerance);
+	TestEqual(TEXT("Taper below MinZ"), applyDeformer(taper, FVector(10.f, 20.f, -50.f)), FVector(10.f, 20.f, -50.f), tolerance);
+
+	// ֻƶ (max, max, max) ĿƵ, ĵȨ1/8
+	FDeformMeshDeformer lattice;
+	lattice.Kind = EDeformMeshDeformerKind::Lattice;
+	lattice.LatticeBox = FBox(FVector(-50.f), FVector(50.f));
+	lattice.LatticeOffsets.SetNumZeroed(8);
+	lattice.LatticeOffsets[7] = FVector(0.f, 0.f, 10.f);
+	TestEqual(TEXT("Lattice moved corner"), applyDeformer(lattice, FVector(50.f)), FVector(50.f, 50.f, 60.f), tolerance);
+	TestEqual(TEXT("Lattice center"), applyDeformer(lattice, FVector(0.f)), FVector(0.f, 0.f, 1.25f), tolerance);
+	TestEqual(TEXT("Lattice fixed corner"), applyDeformer(lattice, FVector(-50.f)), FVector(-50.f), tolerance);
+
+	// deform Ȩ浽deform origin ľƽ˥, 100 ֮ⲻ
+	// žתú󲻱, ԲDeformTransforms תԼ
+	const FMatrix scale2 = FScaleMatrix(FVector(2.f));
+	TestEqual(TEXT("PreDeform at distance 10"), DeformMeshPreDeformPosition(FVector(10.f, 0.f, 0.f), scale2, FMatrix::Identity),
+		FVector(19.9f, 0.f, 0.f), tolerance);
+	TestEqual(TEXT("PreDeform at distance 50"), DeformMeshPreDeformPosition(FVector(0.f, 50.f, 0.f), scale2, FMatrix::Identity),
+		FVector(0.f, 87.5f, 0.f), tolerance);
+	TestEqual(TEXT("PreDeform past distance 100"), DeformMeshPreDeformPosition(FVector(0.f, 0.f, 200.f), scale2, FMatrix::Identity),
+		FVector(0.f, 0.f, 200.f), tolerance);
+	// world space ԭʼλü
+	TestEqual(TEXT("PreDeform with local to world"),
+		DeformMeshPreDeformPosition(FVector(10.f, 0.f, 0.f), scale2, FTranslationMatrix(FVector(1000.f, 0.f, 0.f))),
+		FVector(1010.f, 0.f, 0.f), tolerance);
+
+	// 汾͵汾һ
+	const TArray<FVector> localPositions = { FVector(10.f, 0.f, 0.f), FVector(0.f, 50.f, 0.f), FVector(0.f, 0.f, 200.f) };
+	TArray<FVector> batchPositions;
+	batchPositions.SetNumUninitialized(localPositions.Num());
+	DeformMeshPreDeformPositions(localPositions, scale2, FMatrix::Identity, batchPositions);
+	for (int32 i = 0; i < localPositions.Num(); i++)
+	{
+		TestEqual(TEXT("PreDeform batch"), batchPositions[i], DeformMeshPreDeformPosition(localPositions[i], scale2, FMatrix::Identity));
+	}
+
+	return true;
+}
+
+/**
+ * CalcDeformMeshDeformerBounds סbox ܼбκĵ, bend twist Ļ
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDeformMeshDeformerBoundsTest, "Plugins.DeformMesh.DeformerBounds", DeformMeshTests::TestFlags)
+
+bool FDeformMeshDeformerBoundsTest::RunTest(const FString& Parameters)
+{
+	FRandomStream random(15);
+	constexpr int32 numSamples = 24;
+
+	for (int32 iteration = 0; iteration < 200; iteration++)
+	{
+		FDeformMeshDeformer deformer;
+		deformer.Kind = (EDeformMeshDeformerKind)random.RandRange((int32)EDeformMeshDeformerKind::Bend, (int32)EDeformMeshDeformerKind::Lattice);
+		deformer.Amount = (random.FRand() < 0.5f ? -1.f : 1.f) * FMath::Pow(10.f, random.FRandRange(-4.f, -1.f));
+		deformer.MinZ = random.FRandRange(-100.f, 50.f);
+		deformer.MaxZ = deformer.MinZ + random.FRandRange(0.f, 200.f);
+		deformer.TaperStartScale = random.FRandRange(0.f, 2.f);
+		deformer.TaperEndScale = random.FRandRange(0.f, 2.f);
+		for (int32 i = 0; i < 8; i++)
+		{
+			deformer.LatticeOffsets.Add(random.VRand() * random.FRandRange(0.f, 30.f));
+		}
+
+		const FVector boxMin(random.FRandRange(-100.f, 0.f), random.FRandRange(-100.f, 0.f), random.FRandRange(-100.f, 0.f));
+		const FBox localBox(boxMin, boxMin + FVector(random.FRandRange(1.f, 200.f), random.FRandRange(1.f, 200.f), random.FRandRange(1.f, 200.f)));
+		const FBox bounds = CalcDeformMeshDeformerBounds(deformer, localBox);
+
+		TArray<FVector4> params;
+		PackDeformMeshDeformerParams(deformer, params);
+		// float κĳߴŴ
+		const FBox expandedBounds = bounds.ExpandBy(1e-3f * FMath::Max(1.f, bounds.GetExtent().GetMax()));
+		for (int32 iz = 0; iz <= numSamples * 4; iz++)
+		{
+			for (int32 iy = 0; iy <= numSamples; iy++)
+			{
+				for (int32 ix = 0; ix <= numSamples; ix++)
+				{
+					const FVector alpha(ix / float(numSamples), iy / float(numSamples), iz / float(numSamples * 4));
+					const FVector deformedPosition = ApplyDeformMeshDeformer(deformer.Kind, params.GetData(), localBox.Min + localBox.GetSize() * alpha);
+					if (!expandedBounds.IsInsideOrOn(deformedPosition))
+					{
+						AddError(FString::Printf(TEXT("Deformer kind %d: %s is outside bounds %s of box %s"), (int32)deformer.Kind,
+							*deformedPosition.ToString(), *bounds.ToString(), *localBox.ToString()));
+						return false;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * r.DeformMesh.UpdateQueueStress һ, 4 ̸߳push һ¼, ͬʱڲ߳drain
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDeformMeshUpdateQueueStressTest, "Plugins.DeformMesh.UpdateQueueStress", DeformMeshTests::TestFlags)
+
+bool FDeformMeshUpdateQueueStressTest::RunTest(const FString& Parameters)
+{
+	FString summary;
+	const bool bPassed = RunDeformMeshUpdateQueueStress(4, 1000000, summary);
+	if (bPassed)
+	{
+		AddInfo(summary);
+	}
+	else
+	{
+		AddError(summary);
+	}
+	return bPassed;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
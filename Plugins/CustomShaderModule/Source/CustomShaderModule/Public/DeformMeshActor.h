@@ -7,7 +7,12 @@
 #include "DeformMeshActor.generated.h"
 
 class UDeformMeshComponent;
+class UDeformMeshActorSubsystem;
 
+/**
+ * DeformController transform section 0, UDeformMeshActorSubsystem , actor Լtick
+ * ûDeformController ʱԼDeformControllerComponent
+ */
 UCLASS()
 class CUSTOMSHADERMODULE_API ADeformMeshActor : public AActor
 {
@@ -21,16 +26,41 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+public:	
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "DeformMesh")
 	UDeformMeshComponent* DeformMeshComp;
 
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "DeformMesh")
 	UStaticMesh* SourceMesh;
 
+	// ΪʱDeformControllerComponent
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "DeformMesh")
 	AActor* DeformController;
+
+	// Ĭϵcontroller, ʹþtransform, actor ƶ
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Category = "DeformMesh")
+	USceneComponent* DeformControllerComponent;
+
+	/** ǰcontroller world transform */
+	FTransform GetControllerTransform() const;
+
+	// DeformController transform ϴθʱĲ𲻳ֵʱsection
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "DeformMesh", meta = (ClampMin = "0"))
+	float TransformTolerance = KINDA_SMALL_NUMBER;
+
+private:
+	/** controller ƶ, subsystem һTick ʱȽtransform */
+	void OnControllerTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	// controller root component ʱTransformUpdated, ûƶʱsubsystem actor
+	// ֻDeformController ûroot component ʱÿ֡Ƚtransform
+	TWeakObjectPtr<USceneComponent> ControllerRoot;
+	FDelegateHandle ControllerTransformUpdatedHandle;
+
+	// UDeformMeshActorSubsystem еλ, ûעʱINDEX_NONE
+	int32 BatchTickIndex = INDEX_NONE;
+
+	friend class UDeformMeshActorSubsystem;
 };
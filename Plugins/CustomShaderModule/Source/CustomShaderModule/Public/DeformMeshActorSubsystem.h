@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "DeformMeshActorSubsystem.generated.h"
+
+class ADeformMeshActor;
+
+/**
+ * ÿADeformMeshActor ԼTick, һֻ֡һ:
+ * controller transform ռ, ParallelFor зֿȽ,
+ * 仯˵actor UDeformMeshComponent::UpdateSectionTransformsBatched, ÿcomponent render command
+ */
+UCLASS()
+class CUSTOMSHADERMODULE_API UDeformMeshActorSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * ֮ÿ֡actor controller, bPollEveryFrame Ϊfalse ʱֻMarkActorDirty actor
+	 */
+	void RegisterActor(ADeformMeshActor* Actor, bool bPollEveryFrame);
+
+	void UnregisterActor(ADeformMeshActor* Actor);
+
+	/** actor controller ƶ, һTick ʱ */
+	void MarkActorDirty(ADeformMeshActor* Actor);
+
+	inline int32 GetNumActors() const { return Actors.Num(); }
+
+	//~ FTickableGameObject
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override;
+	TStatId GetStatId() const override;
+
+private:
+	// 鰴actor עλ, ɾʱһ
+	UPROPERTY(Transient)
+	TArray<ADeformMeshActor*> Actors;
+
+	// ϴθsection ʱcontroller transform
+	TArray<FTransform> LastTransforms;
+
+	// ûtransform 仯֪ͨactor ÿ֡ҪȽ
+	TBitArray<> PollEveryFrame;
+
+	// ϴTick ֮յtransform 仯֪ͨ
+	TBitArray<> DirtyActors;
+
+	// Tick ֻб, ûѯactor Ҳû֪ͨʱ֡ʲô
+	// actor λ, ɾʱλû
+	TArray<ADeformMeshActor*> PolledActors;
+	TArray<ADeformMeshActor*> DirtyList;
+
+	// Tick иõʱ, һ֡ҪȽϵactor, ǵcontroller transform, ȽϽ
+	TArray<int32> CandidateActors;
+	TArray<FTransform> CandidateTransforms;
+	TArray<uint8> CandidateChanged;
+};
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DeformMeshBenchmarkCommandlet.generated.h"
+
+/**
+ * UDeformMeshComponent scalability benchmark, һʱgame world 
+ *
+ * UE4Editor-Cmd <Project>.uproject -run=DeformMeshBenchmark -nullrhi
+ *     -Actors=1,16,64            ÿspawn ADeformMeshActor 
+ *     -Sections=16,256,4096      ÿactor section 
+ *     -UpdateFractions=0,0.1,1   ÿ֡UpdateSectionTransform µsection 
+ *     -Frames=120 -WarmupFrames=10 -Seed=1
+ *     -Mesh=/Engine/BasicShapes/Cube.Cube
+ *     -Output=Saved/DeformMeshBenchmark.csv   չ.json ʱJSON
+ *     -PerFrame                  ͬʱÿһ֡ʱ (<Output>_frames.csv)
+ *
+ * ȽȾʱ -dpcvars=,  -dpcvars=r.DeformMesh.AsyncProxyBuild=0 Աspawn SpawnMs FirstFrameMs
+ *     -CompareAsyncProxyBuild    ÿr.DeformMesh.AsyncProxyBuild=0 õǰֵ (Ĭ256) , нͲֵ,
+ *                                ֻrender scene ʱ, -nullrhi proxy
+ *
+ * бÿһн. -nullrhi ʱscene ǿյ, ᴴproxy, ֻgame thread ʱ,
+ * ʱrender thread, Flush ProxyReadyFrame CSV , JSON null
+ *
+ * proxy render thread ʱ -AllowCommandletRendering -RenderOffscreen  -nullrhi,
+ *     -RequireRenderScene        ûrender scene ʱ˳, ֻgame thread Ľ
+ *     -ProxyIterations=1000      һ֮֡ÿproxy ظGetDynamicMeshElements section  (޳, ѡLOD, mesh batch),
+ *                                ProxyIterationMs,  -Actors=1 -Sections=10000 -UpdateFractions=0 10k section proxy
+ */
+UCLASS()
+class CUSTOMSHADERMODULE_API UDeformMeshBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDeformMeshBenchmarkCommandlet();
+
+	int32 Main(const FString& Params) override;
+};
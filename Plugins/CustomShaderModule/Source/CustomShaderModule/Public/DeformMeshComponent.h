@@ -4,8 +4,65 @@
 
 #include "CoreMinimal.h"
 #include "Components/MeshComponent.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "DeformMeshComponent.generated.h"
 
+struct FDeformMeshProxyBuildData;
+
+/**
+ * rigid deform transform ֮ǰ, section local λķǸԱ
+ * ÿֶvertex factory һshader permutation, ֻ r.DeformMesh.Deformers д򿪵ᱻ
+ */
+UENUM(BlueprintType)
+enum class EDeformMeshDeformerKind : uint8
+{
+	// ֻdeform transform
+	Rigid = 0,
+	// local Y Z Բ
+	Bend = 1,
+	// local Z Ťת
+	Twist = 2,
+	// local Z XY
+	Taper = 3,
+	// 2x2x2 free form lattice
+	Lattice = 4,
+};
+
+USTRUCT(BlueprintType)
+struct FDeformMeshDeformer
+{
+	GENERATED_BODY()
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Deformer)
+	EDeformMeshDeformerKind Kind = EDeformMeshDeformerKind::Rigid;
+
+	// Bend: ÿλĻ (), Twist: ÿλŤתĻ
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Deformer)
+	float Amount = 0.f;
+
+	// Bend, Twist, Taper õlocal Z Χ, Χ֮ⱣַΧ˵ı
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Deformer)
+	float MinZ = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Deformer)
+	float MaxZ = 100.f;
+
+	// Taper: MinZ MaxZ XY 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Deformer)
+	float TaperStartScale = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Deformer)
+	float TaperEndScale = 1.f;
+
+	// Lattice: lattice ǵlocal box
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Deformer)
+	FBox LatticeBox = FBox(FVector(-50.f), FVector(50.f));
+
+	// Lattice: 8 Ƶƫ, ± x + 2 * y + 4 * z, 8 İ0 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Deformer)
+	TArray<FVector> LatticeOffsets;
+};
 
 USTRUCT()
 struct FDeformMeshSection
@@ -26,9 +83,17 @@ public:
 	UPROPERTY()
 	bool bSectionVisible;
 
+	UPROPERTY()
+	FDeformMeshDeformer Deformer;
+
+	// Deformer ֮static mesh local box, ûгDeformTransform
+	UPROPERTY()
+	FBox DeformedMeshBox;
+
 	FDeformMeshSection()
 		: SectionBoundingBox(ForceInit) // ʼFBoxΪЧ
 		, bSectionVisible(true)
+		, DeformedMeshBox(ForceInit)
 	{
 		
 	}
@@ -38,9 +103,39 @@ public:
 		StaticMesh = nullptr;
 		SectionBoundingBox.Init();
 		bSectionVisible = true;
+		Deformer = FDeformMeshDeformer();
+		DeformedMeshBox.Init();
 	}
 };
 
+/**
+ * section bounds ߶, Ҷÿsection bounds, section bounds
+ * һsection ֻҪºϲ·ϵĽڵ, O(log N)
+ */
+struct FDeformMeshBoundsTree
+{
+public:
+	/** NumLeaves section ·, ҶӶЧbox */
+	void Reset(int32 NumLeaves);
+
+	/** һҶӲϺϲ */
+	void Update(int32 Leaf, const FBox& Box);
+
+	/** section ϲbounds, ûЧsection ʱЧbox */
+	inline const FBox& GetRoot() const { return Nodes[1]; }
+
+	inline int32 GetNumLeaves() const { return NumLeaves; }
+
+	inline SIZE_T GetAllocatedSize() const { return Nodes.GetAllocatedSize(); }
+
+private:
+	// Ҷ, ȡ2 
+	int32 NumLeaves = 0;
+
+	// 1 ʼȫ, Ҷ [NumLeaves, 2 * NumLeaves)
+	TArray<FBox> Nodes = { FBox(ForceInit), FBox(ForceInit) };
+};
+
 /**
  * 
  */
@@ -52,38 +147,163 @@ class CUSTOMSHADERMODULE_API UDeformMeshComponent : public UMeshComponent
 public:
 	void CreateSection(int32 SectionIndex, UStaticMesh* SourceMesh, const FTransform& DeformTransform);
 
+	/**
+	 * һsection, صsection index Ϊhandle section , ClearSection ֮ʧЧ
+	 * ȸClearSection ճindex, ûʱ, section 鲻Ϊɾϡ
+	 */
+	int32 AddSection(UStaticMesh* SourceMesh, const FTransform& DeformTransform);
+
 	void UpdateSectionTransform(int32 SectionIndex, const FTransform& DeformTransform);
 
+	/**
+	 * һθ¶section transform: ֻ¼һbounds
+	 * SectionIndices  DeformTransforms һһӦ
+	 */
+	void UpdateSectionTransforms(TArrayView<const int32> SectionIndices, TArrayView<const FTransform> DeformTransforms);
+
+	UFUNCTION(BlueprintCallable, Category = "Components|DeformMesh", meta = (DisplayName = "Update Section Transforms"))
+	void K2_UpdateSectionTransforms(const TArray<int32>& SectionIndices, const TArray<FTransform>& DeformTransforms);
+
+	/**
+	 * һθ¶component section transform, FinishDeformUpdate, section ݺbounds ParallelFor и,
+	 * update queue ļ¼game thread push, Ժͬһ֡UpdateSectionTransform ˳Ч
+	 * ͬһcomponent Գֶ, section ͬһtask а˳
+	 * µbounds scene еbounds ʱMarkRenderTransformDirty, ֻм¼render thread
+	 * һһӦ
+	 */
+	static void UpdateSectionTransformsBatched(TArrayView<UDeformMeshComponent* const> Components,
+		TArrayView<const int32> SectionIndices, TArrayView<const FTransform> DeformTransforms);
+
 	void FinishDeformUpdate();
 
 	void ClearSection(int32 SectionIndex);
 
 	void ClearAllMeshSections();
 
+	/**
+	 * ͷsection ڴ, proxy ɾsection µĿtransform slot ѹ
+	 * slot  r.DeformMesh.SlotCompaction ʱproxy Զѹ, ﲻֵ, ısection index
+	 */
+	void CompactSections();
+
 	void SetMeshSectionVisible(int32 SectionIndex, bool bNewVisibility);
 
+	int32 GetNumSections() const { return DeformMeshSections.Num(); }
+
+	/** section DeformTransform ֮local bounds, section Чindex Чbox */
+	FBox GetSectionBoundingBox(int32 SectionIndex) const;
+
+	/**
+	 * section ķǸdeformer, ؽproxy, ʺÿ֡
+	 * û r.DeformMesh.Deformers дʱRigid 
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Components|DeformMesh")
+	void SetSectionDeformer(int32 SectionIndex, const FDeformMeshDeformer& Deformer);
+
+	UFUNCTION(BlueprintCallable, Category = "Components|DeformMesh")
+	void SetLODBias(int32 NewLODBias);
 
 
+
+	/**
+	 * section  r.DeformMesh.AsyncProxyBuild ʱ, һεtask graph Ͽʼbuild nullptr,
+	 * build ɺ´render state ʱŷproxy
+	 */
 	FPrimitiveSceneProxy* CreateSceneProxy() override;
 
+	void SetMaterial(int32 ElementIndex, UMaterialInterface* Material) override;
+
 
 	int32 GetNumMaterials() const override;
 
 
 	FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
 
+	/** ȴupdate queue proxy ļ¼, ɾproxy */
+	void DestroyRenderState_Concurrent() override;
+
+	/** ¼scene bounds, SceneBounds */
+	void CreateRenderState_Concurrent(FRegisterComponentContext* Context) override;
+
+	void SendRenderTransform_Concurrent() override;
+
+	/** section ݵڴ, proxy ڴ r.DeformMesh.DumpMemory */
+	void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+
+	void PostLoad() override;
+
 public:
 
 	//FPrimitiveSceneProxy* SceneProxy;
 
+	/**
+	 * ÿsection ĻߴѡLOD ټֵ, 0 ʹø;ȵLOD
+	 * ʱ޸SetLODBias
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = LOD, meta = (ClampMin = "0"))
+	int32 LODBias = 0;
+
 
 private:
 	UPROPERTY()
 	TArray<FDeformMeshSection> DeformMeshSections;
 
+	// ClearSection ճsection index, AddSection ĩβȡ, ȡʱѾCreateSection ʹõ
+	// л, PostLoad ؽ
+	TArray<int32> FreeSectionIndices;
+
 	UPROPERTY()
 	FBoxSphereBounds LocalBounds;
 
+	// л, section ʱ(֮) ؽ
+	FDeformMeshBoundsTree SectionBoundsTree;
+
+	// һνscene world bounds (AddPrimitive UpdatePrimitiveTransform), ܱBounds 
+	FBoxSphereBounds SceneBounds = FBoxSphereBounds(ForceInit);
+
 	friend class FDeformMeshSceneProxy;
 	void UpdateLocalBounds();
+
+	/** UpdateLocalBounds вҪgame thread Ĳ: ¼LocalBounds Bounds, ͬcomponent ڲͬ߳ͬʱ */
+	void UpdateLocalBoundsConcurrent();
+
+	/** Bounds SceneBounds, ߱Сܶʱscene еbounds Ҫ */
+	bool NeedsSceneBoundsUpdate() const;
+
+	/** һsection SectionBoundingBox µSectionBoundsTree , LocalBounds */
+	void UpdateSectionBounds(int32 SectionIndex);
+
+	/** section ؽSectionBoundsTree */
+	void RebuildSectionBoundsTree();
+
+	/** ȥĩβĿsection ǵoverride material */
+	void TrimTrailingSections();
+
+	/** пsection ؽFreeSectionIndices */
+	void RebuildFreeSectionIndices();
+
+	/** game thread section , ظrender thread ľ, section Чʱfalse */
+	bool SetSectionDeformTransform(int32 SectionIndex, const FTransform& DeformTransform, FMatrix& OutTransformMatrix);
+
+	/**
+	 * ֱܷlive proxy ӻɾsection (r.DeformMesh.InPlaceSectionChanges), ʱؽrender state
+	 * pre deform ʱֻɾ
+	 */
+	bool CanChangeSectionsInPlace(bool bAddingSection) const;
+
+	/** ƴproxy Ҫsection , ֮߳build */
+	TSharedRef<FDeformMeshProxyBuildData, ESPMode::ThreadSafe> CreateProxyBuildData();
+
+	// section , ɾımesh//deformer ʱһ, ̨build Ľһ¾
+	uint32 SectionLayoutVersion = 0;
+
+	// ÿlive proxy ӻɾsection һ, update queue ļ¼, proxy жϼ¼ĸsection layout
+	uint16 InPlaceSectionSerial = 0;
+
+	// ϴθƿ֮transform ɼԱ
+	bool bProxyBuildTransformsStale = false;
+
+	// ڽлѾ, ûбCreateSceneProxy ʹõĺ̨build
+	TSharedPtr<FDeformMeshProxyBuildData, ESPMode::ThreadSafe> ProxyBuildData;
+	FGraphEventRef ProxyBuildTask;
 };